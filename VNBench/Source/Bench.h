@@ -0,0 +1,143 @@
+#ifndef VN_BENCH_BENCH_H
+#define VN_BENCH_BENCH_H
+
+#include <Core/DataTypes.h>
+
+#include <chrono>
+
+// ============================================================================
+
+/// <summary>
+/// High resolution timer used to measure benchmark sections
+/// </summary>
+class BenchTimer
+{
+public:
+	BenchTimer() :
+		mStart		(std::chrono::high_resolution_clock::now())
+	{ }
+
+	/// <summary>
+	/// Restart the timer
+	/// </summary>
+	void restart()
+	{
+		mStart = std::chrono::high_resolution_clock::now();
+	}
+
+	/// <summary>
+	/// Get the time elapsed since the timer was started in nanoseconds
+	/// </summary>
+	/// <returns>Elapsed nanoseconds</returns>
+	double elapsedNs() const
+	{
+		return std::chrono::duration<double, std::nano>(std::chrono::high_resolution_clock::now() - mStart).count();
+	}
+
+private:
+	/// <summary>
+	/// Start time
+	/// </summary>
+	std::chrono::high_resolution_clock::time_point mStart;
+};
+
+// ============================================================================
+
+/// <summary>
+/// Run a timed function several times and get the fastest time per operation.
+/// The fastest run is the one least disturbed by the rest of the system
+/// </summary>
+/// <param name="numRuns">Number of runs</param>
+/// <param name="numOps">Number of operations done by each call to func</param>
+/// <param name="func">Function that does numOps operations</param>
+/// <returns>Nanoseconds per operation</returns>
+template <typename F>
+double minTimeNs(vne::Uint32 numRuns, vne::Uint32 numOps, F func)
+{
+	double best = 0.0;
+	for (vne::Uint32 i = 0; i < numRuns; ++i)
+	{
+		BenchTimer timer;
+		func();
+		double ns = timer.elapsedNs() / numOps;
+
+		if (i == 0 || ns < best)
+			best = ns;
+	}
+
+	return best;
+}
+
+/// <summary>
+/// Record a result so it can be written as JSON and compared against a baseline.
+/// Names should stay the same between runs (i.e. "variant/assign int")
+/// </summary>
+/// <param name="name">Result name</param>
+/// <param name="value">Measured value</param>
+/// <param name="unit">Unit of the value (i.e. "ns")</param>
+/// <param name="higherIsBetter">True for rates, false for times</param>
+void reportResult(const char* name, double value, const char* unit, bool higherIsBetter = false);
+
+/// <summary>
+/// Record a failed correctness check, VNBench exits with an error if any check failed
+/// </summary>
+/// <param name="name">Name of the check</param>
+void reportFailure(const char* name);
+
+/// <summary>
+/// Get the number of failed correctness checks
+/// </summary>
+/// <returns>Number of failures</returns>
+vne::Uint32 getNumFailures();
+
+/// <summary>
+/// Write all reported results as JSON, one result per line
+/// </summary>
+/// <param name="path">Output file</param>
+/// <returns>True if the file was written</returns>
+bool writeResults(const char* path);
+
+/// <summary>
+/// Compare reported results against the results of a previous run written by writeResults().
+/// Prints the change of every result that is in both runs
+/// </summary>
+/// <param name="path">Baseline file</param>
+/// <param name="threshold">Allowed change in percent before a result counts as a regression</param>
+/// <returns>Number of regressions, or -1 if the baseline couldn't be read</returns>
+int compareResults(const char* path, double threshold);
+
+// ============================================================================
+
+/// <summary>
+/// Object pool create / free benchmarks
+/// </summary>
+void runPoolBenchmarks();
+
+/// <summary>
+/// Thread safe object pool stress test and throughput benchmarks, and concurrent packed folder reads
+/// </summary>
+void runConcurrentBenchmarks();
+
+/// <summary>
+/// Interned name lookup benchmarks
+/// </summary>
+void runNameBenchmarks();
+
+/// <summary>
+/// Compiled condition benchmarks
+/// </summary>
+void runConditionBenchmarks();
+
+/// <summary>
+/// Generated stress scene scaling benchmarks, run with a headless engine
+/// </summary>
+void runStressBenchmarks();
+
+/// <summary>
+/// Micro benchmarks of the engine's hot paths, all results are reported
+/// </summary>
+void runMicroBenchmarks();
+
+// ============================================================================
+
+#endif
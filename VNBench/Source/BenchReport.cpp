@@ -0,0 +1,148 @@
+#include <Bench.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace vne;
+
+// ============================================================================
+
+namespace
+{
+/* Reported result */
+struct BenchResult
+{
+	std::string mName;
+	double mValue;
+	std::string mUnit;
+	bool mHigherIsBetter;
+};
+
+std::vector<BenchResult> gResults;
+
+/* Names of failed checks */
+std::vector<std::string> gFailures;
+
+/* Write a string with JSON escapes */
+void writeString(FILE* f, const std::string& str)
+{
+	fputc('"', f);
+	for (Uint32 i = 0; i < str.size(); ++i)
+	{
+		if (str[i] == '"' || str[i] == '\\')
+			fputc('\\', f);
+		fputc(str[i], f);
+	}
+	fputc('"', f);
+}
+
+/* Read the string value of a key on a line written by writeResults() */
+bool readString(const char* line, const char* key, std::string& str)
+{
+	const char* c = strstr(line, key);
+	if (!c) return false;
+
+	str.clear();
+	for (c += strlen(key); *c && *c != '"'; ++c)
+	{
+		if (*c == '\\' && c[1])
+			++c;
+		str += *c;
+	}
+
+	return *c == '"';
+}
+}
+
+// ============================================================================
+
+void reportResult(const char* name, double value, const char* unit, bool higherIsBetter)
+{
+	BenchResult result;
+	result.mName = name;
+	result.mValue = value;
+	result.mUnit = unit;
+	result.mHigherIsBetter = higherIsBetter;
+	gResults.push_back(result);
+}
+
+void reportFailure(const char* name)
+{
+	gFailures.push_back(name);
+}
+
+Uint32 getNumFailures()
+{
+	return (Uint32)gFailures.size();
+}
+
+bool writeResults(const char* path)
+{
+	FILE* f = fopen(path, "w");
+	if (!f) return false;
+
+	fprintf(f, "{\"results\":[\n");
+	for (Uint32 i = 0; i < gResults.size(); ++i)
+	{
+		const BenchResult& result = gResults[i];
+
+		fprintf(f, "{\"name\":");
+		writeString(f, result.mName);
+		fprintf(f, ",\"value\":%.6g,\"unit\":", result.mValue);
+		writeString(f, result.mUnit);
+		fprintf(f, ",\"higherIsBetter\":%s}%s\n", result.mHigherIsBetter ? "true" : "false", i + 1 < gResults.size() ? "," : "");
+	}
+	fprintf(f, "]}\n");
+
+	fclose(f);
+	return true;
+}
+
+int compareResults(const char* path, double threshold)
+{
+	FILE* f = fopen(path, "r");
+	if (!f) return -1;
+
+	// Results are one per line, so the baseline is read line by line
+	std::unordered_map<std::string, double> baseline;
+	char line[1024];
+	while (fgets(line, sizeof(line), f))
+	{
+		std::string name;
+		const char* value = strstr(line, "\"value\":");
+		if (readString(line, "\"name\":\"", name) && value)
+			baseline[name] = strtod(value + 8, 0);
+	}
+	fclose(f);
+
+	printf("Comparison with %s (positive change is worse, regression threshold %.1f%%)\n", path, threshold);
+	printf("%-40s %12s %12s %9s\n", "result", "baseline", "current", "change");
+
+	int numRegressions = 0;
+	for (Uint32 i = 0; i < gResults.size(); ++i)
+	{
+		const BenchResult& result = gResults[i];
+
+		auto it = baseline.find(result.mName);
+		if (it == baseline.end() || it->second == 0.0) continue;
+
+		// Positive change is always worse
+		double change = (result.mValue - it->second) / it->second * 100.0;
+		if (result.mHigherIsBetter)
+			change = -change;
+
+		bool regressed = change > threshold;
+		numRegressions += regressed;
+
+		printf("%-40s %12.4g %12.4g %+8.1f%%%s\n", result.mName.c_str(), it->second, result.mValue, change, regressed ? " REGRESSION" : "");
+	}
+
+	printf("%d regression%s\n\n", numRegressions, numRegressions == 1 ? "" : "s");
+	return numRegressions;
+}
+
+// ============================================================================
@@ -0,0 +1,350 @@
+#include <Bench.h>
+
+#include <Core/ObjectPool.h>
+
+#include <Engine/Resource.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+using namespace vne;
+
+// ============================================================================
+
+namespace
+{
+
+/* Number of constructed objects that haven't been destroyed */
+std::atomic<int> gNumLive(0);
+
+/* Object stamped with its owner, so a slot that is handed out twice gets caught */
+struct StampedObject
+{
+	StampedObject(Uint32 thread, Uint32 seq) :
+		mThread(thread),
+		mSeq(seq)
+	{
+		++gNumLive;
+	}
+
+	~StampedObject()
+	{
+		--gNumLive;
+	}
+
+	Uint32 mThread;
+	Uint32 mSeq;
+	Uint8 mPadding[56];
+};
+
+/* Objects passed between threads so they get freed by a different thread than the one that created them */
+struct Exchange
+{
+	std::mutex mMutex;
+	std::vector<StampedObject*> mObjects;
+};
+
+/* Cheap per thread random numbers */
+Uint32 nextRandom(Uint32& state)
+{
+	state ^= state << 13;
+	state ^= state >> 17;
+	state ^= state << 5;
+	return state;
+}
+
+}
+
+// ============================================================================
+
+void benchConcurrentStress()
+{
+	printf("ConcurrentObjectPool stress test (8 threads, cross thread frees)\n");
+
+	const Uint32 numThreads = 8;
+	const Uint32 numOps = 200000;
+
+	ConcurrentObjectPool<StampedObject> pool;
+	Exchange exchange;
+	std::atomic<Uint32> numErrors(0);
+
+	std::vector<std::thread> threads;
+	for (Uint32 t = 0; t < numThreads; ++t)
+	{
+		threads.push_back(std::thread([&, t]()
+		{
+			std::vector<StampedObject*> objects;
+			Uint32 random = 2463534242u + t * 7919u;
+
+			for (Uint32 i = 0; i < numOps; ++i)
+			{
+				Uint32 r = nextRandom(random);
+
+				if (objects.empty() || r % 3)
+				{
+					StampedObject* object = pool.create(t, i);
+					objects.push_back(object);
+				}
+				else
+				{
+					StampedObject* object = objects[r % objects.size()];
+					objects[r % objects.size()] = objects.back();
+					objects.pop_back();
+
+					// Every few frees, hand the object to another thread instead
+					if (r % 5 == 0)
+					{
+						std::lock_guard<std::mutex> lock(exchange.mMutex);
+						exchange.mObjects.push_back(object);
+						continue;
+					}
+
+					if (object->mThread != t)
+						++numErrors;
+					pool.free(object);
+				}
+
+				// Free some objects created by other threads
+				if (r % 64 == 0)
+				{
+					std::lock_guard<std::mutex> lock(exchange.mMutex);
+					for (Uint32 j = 0; j < exchange.mObjects.size(); ++j)
+						pool.free(exchange.mObjects[j]);
+					exchange.mObjects.clear();
+				}
+			}
+
+			// Check that no other thread was given one of this thread's objects
+			for (Uint32 i = 0; i < objects.size(); ++i)
+			{
+				if (objects[i]->mThread != t)
+					++numErrors;
+			}
+
+			// Leave one object in the exchange, so free() has live objects to destroy
+			std::lock_guard<std::mutex> lock(exchange.mMutex);
+			for (Uint32 i = 0; i < objects.size(); ++i)
+			{
+				if (i == 0)
+					exchange.mObjects.push_back(objects[i]);
+				else
+					pool.free(objects[i]);
+			}
+		}));
+	}
+
+	for (Uint32 t = 0; t < numThreads; ++t)
+		threads[t].join();
+
+	// Objects still in the exchange are destroyed by the pool
+	int numLeft = (int)exchange.mObjects.size();
+	int numLive = gNumLive;
+	pool.free();
+
+	bool passed = !numErrors && numLive == numLeft && gNumLive == 0;
+	printf("%s (%u stamp errors, %d live before free, %d expected)\n\n", passed ? "passed" : "FAILED", (Uint32)numErrors, numLive, numLeft);
+	if (!passed)
+		reportFailure("concurrent/pool stress");
+}
+
+// ============================================================================
+
+void benchConcurrentThroughput()
+{
+	printf("Multi threaded create + free throughput (million ops/s)\n");
+	printf("%10s %14s %14s\n", "threads", "mutex pool", "concurrent");
+
+	const Uint32 numThreadCounts[] = { 1, 2, 4, 8 };
+	const Uint32 numOps = 1000000;
+	const Uint32 numHeld = 256;
+
+	for (Uint32 numThreads : numThreadCounts)
+	{
+		double rates[2];
+
+		for (Uint32 mode = 0; mode < 2; ++mode)
+		{
+			ObjectPool<StampedObject> lockedPool;
+			std::mutex lockedMutex;
+			ConcurrentObjectPool<StampedObject> pool;
+
+			BenchTimer timer;
+
+			std::vector<std::thread> threads;
+			for (Uint32 t = 0; t < numThreads; ++t)
+			{
+				threads.push_back(std::thread([&, t]()
+				{
+					StampedObject* held[numHeld] = { };
+
+					for (Uint32 i = 0; i < numOps; ++i)
+					{
+						StampedObject*& slot = held[i % numHeld];
+
+						if (mode == 0)
+						{
+							std::lock_guard<std::mutex> lock(lockedMutex);
+							lockedPool.free(slot);
+							slot = lockedPool.create(t, i);
+						}
+						else
+						{
+							pool.free(slot);
+							slot = pool.create(t, i);
+						}
+					}
+
+					for (Uint32 i = 0; i < numHeld; ++i)
+					{
+						if (mode == 0)
+						{
+							std::lock_guard<std::mutex> lock(lockedMutex);
+							lockedPool.free(held[i]);
+						}
+						else
+							pool.free(held[i]);
+					}
+				}));
+			}
+
+			for (Uint32 t = 0; t < numThreads; ++t)
+				threads[t].join();
+
+			// Each iteration is one create and one free
+			rates[mode] = 2.0 * numOps * numThreads / timer.elapsedNs() * 1.0e3;
+		}
+
+		printf("%10u %14.2f %14.2f\n", numThreads, rates[0], rates[1]);
+	}
+
+	printf("\n");
+}
+
+// ============================================================================
+
+void benchPackedConcurrentReads()
+{
+	printf("Concurrent packed folder reads (MB/s, every read checked byte for byte)\n");
+	printf("%10s %14s %10s %14s %10s\n", "threads", "mapped", "speedup", "positional", "speedup");
+
+	const Uint32 numFiles = 16;
+	const Uint32 fileSize = 256 * 1024;
+	const Uint32 numRounds = 8;
+
+	// Half the files compress, so reads include inflating, the other half are stored
+	const char* sentence = "The quick brown fox jumps over the lazy dog. ";
+	std::vector<std::vector<Uint8>> contents(numFiles, std::vector<Uint8>(fileSize));
+	std::vector<std::string> names(numFiles);
+
+#ifdef _WIN32
+	_mkdir("ConcurrentPackAssets");
+#else
+	mkdir("ConcurrentPackAssets", 0755);
+#endif
+
+	for (Uint32 i = 0; i < numFiles; ++i)
+	{
+		Uint32 random = 2463534242u + i * 7919u;
+		for (Uint32 j = 0; j < fileSize; ++j)
+			contents[i][j] = i % 2 ? (Uint8)nextRandom(random) : (Uint8)(sentence[j % 45] + i);
+
+		names[i] = "file" + std::to_string(i) + ".bin";
+
+		FILE* f = fopen(("ConcurrentPackAssets/" + names[i]).c_str(), "wb");
+		if (!f)
+		{
+			printf("Failed to write pack assets\n\n");
+			reportFailure("concurrent/packed reads");
+			return;
+		}
+		fwrite(&contents[i][0], 1, fileSize, f);
+		fclose(f);
+	}
+
+	ResourceFolder::setKey(0);
+	ResourceFolder::setPath("ConcurrentPackAssets");
+	ResourceFolder::pack("ConcurrentPack.pak");
+
+	const Uint32 numThreadCounts[] = { 1, 2, 4, 8 };
+	const Uint32 numCores = std::thread::hardware_concurrency();
+	std::atomic<Uint32> numErrors(0);
+	double baseRates[2] = { 0.0, 0.0 };
+
+	for (Uint32 numThreads : numThreadCounts)
+	{
+		if (numThreads > 1 && numCores && numThreads > numCores) break;
+
+		double rates[2];
+
+		for (Uint32 mode = 0; mode < 2; ++mode)
+		{
+			ResourceFolder::setMemoryMapped(mode == 0);
+			ResourceFolder::setPath("ConcurrentPack.pak");
+
+			BenchTimer timer;
+
+			// Every thread reads every file, starting at a different file
+			std::vector<std::thread> threads;
+			for (Uint32 t = 0; t < numThreads; ++t)
+			{
+				threads.push_back(std::thread([&, t]()
+				{
+					for (Uint32 i = 0; i < numRounds * numFiles; ++i)
+					{
+						Uint32 file = (i + t) % numFiles;
+
+						ResourceData data;
+						if (!ResourceFolder::open(names[file], data) || data.getSize() != fileSize ||
+							memcmp(data.getData(), &contents[file][0], fileSize) != 0)
+							++numErrors;
+					}
+				}));
+			}
+
+			for (Uint32 t = 0; t < numThreads; ++t)
+				threads[t].join();
+
+			rates[mode] = (double)fileSize * numFiles * numRounds * numThreads / timer.elapsedNs() * 1.0e3;
+			if (numThreads == 1)
+				baseRates[mode] = rates[mode];
+
+			std::string name = std::string("pack/concurrent ") + (mode == 0 ? "mapped " : "positional ") + std::to_string(numThreads) + " threads";
+			reportResult(name.c_str(), rates[mode], "MB/s", true);
+		}
+
+		printf("%10u %14.2f %9.2fx %14.2f %9.2fx\n", numThreads,
+			rates[0], rates[0] / baseRates[0], rates[1], rates[1] / baseRates[1]);
+	}
+
+	ResourceFolder::setMemoryMapped(true);
+	ResourceFolder::setPath("");
+	for (Uint32 i = 0; i < numFiles; ++i)
+		remove(("ConcurrentPackAssets/" + names[i]).c_str());
+	remove("ConcurrentPack.pak");
+
+	printf("%s (%u read errors)\n\n", numErrors ? "FAILED" : "passed", (Uint32)numErrors);
+	if (numErrors)
+		reportFailure("concurrent/packed reads");
+}
+
+// ============================================================================
+
+void runConcurrentBenchmarks()
+{
+	benchConcurrentStress();
+	benchConcurrentThroughput();
+	benchPackedConcurrentReads();
+}
+
+// ============================================================================
@@ -0,0 +1,60 @@
+#include <Bench.h>
+
+#include <Core/Condition.h>
+#include <Core/VariableStore.h>
+
+#include <stdio.h>
+#include <functional>
+#include <unordered_map>
+
+using namespace vne;
+
+// ============================================================================
+
+void benchConditionEval()
+{
+	printf("Branch condition \"points >= 10 && !met_bob\" (ns per evaluation)\n");
+	printf("%24s %10s\n", "condition", "ns");
+
+	const Uint32 numEvals = 1000000;
+
+	VariableStore store;
+	store.set(store.add("points"), Variant(12));
+	store.set(store.add("met_bob"), Variant(false));
+
+	// Old style lambda, variables are looked up by name every time
+	std::unordered_map<NameId, Variant> variables;
+	variables[NameId("points")] = Variant(12);
+	variables[NameId("met_bob")] = Variant(false);
+
+	std::function<bool()> lambda = [&]()
+	{
+		return variables.find("points")->second.get<int>() >= 10 && !variables.find("met_bob")->second.get<bool>();
+	};
+
+	Condition condition;
+	condition.compile("points >= 10 && !met_bob", &store);
+
+	Uint32 numTrue = 0;
+
+	BenchTimer timer;
+	for (Uint32 i = 0; i < numEvals; ++i)
+		numTrue += lambda();
+	printf("%24s %10.1f\n", "std::function by name", timer.elapsedNs() / numEvals);
+
+	timer.restart();
+	for (Uint32 i = 0; i < numEvals; ++i)
+		numTrue += condition.evaluate();
+	printf("%24s %10.1f\n", "compiled", timer.elapsedNs() / numEvals);
+
+	printf("(%u true)\n\n", numTrue);
+}
+
+// ============================================================================
+
+void runConditionBenchmarks()
+{
+	benchConditionEval();
+}
+
+// ============================================================================
@@ -0,0 +1,118 @@
+#include <Bench.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+using namespace vne;
+
+// ============================================================================
+
+namespace
+{
+/* Named benchmark group */
+struct BenchGroup
+{
+	const char* mName;
+	void (*mRun)();
+};
+
+const BenchGroup gGroups[] =
+{
+	{ "pool", runPoolBenchmarks },
+	{ "concurrent", runConcurrentBenchmarks },
+	{ "name", runNameBenchmarks },
+	{ "condition", runConditionBenchmarks },
+	{ "stress", runStressBenchmarks },
+	{ "micro", runMicroBenchmarks }
+};
+}
+
+// ============================================================================
+
+int main(int argc, char** argv)
+{
+	// Usage: VNBench [group...] [--json file] [--baseline file] [--threshold percent]
+	// Runs every group if none are given
+	const Uint32 numGroups = sizeof(gGroups) / sizeof(gGroups[0]);
+
+	const char* jsonPath = 0;
+	const char* baselinePath = 0;
+	double threshold = 10.0;
+	std::vector<const char*> names;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		bool isOption = strcmp(argv[i], "--json") == 0 || strcmp(argv[i], "--baseline") == 0 || strcmp(argv[i], "--threshold") == 0;
+		if (isOption)
+		{
+			if (i + 1 >= argc)
+			{
+				printf("Missing value for %s\n", argv[i]);
+				return 1;
+			}
+
+			if (strcmp(argv[i], "--json") == 0)
+				jsonPath = argv[i + 1];
+			else if (strcmp(argv[i], "--baseline") == 0)
+				baselinePath = argv[i + 1];
+			else
+				threshold = atof(argv[i + 1]);
+
+			++i;
+			continue;
+		}
+
+		Uint32 j = 0;
+		while (j < numGroups && strcmp(argv[i], gGroups[j].mName) != 0)
+			++j;
+
+		if (j == numGroups)
+		{
+			printf("Unknown benchmark group: %s\n", argv[i]);
+			return 1;
+		}
+
+		names.push_back(argv[i]);
+	}
+
+	for (Uint32 i = 0; i < numGroups; ++i)
+	{
+		bool run = names.empty();
+		for (Uint32 j = 0; j < names.size() && !run; ++j)
+			run = strcmp(names[j], gGroups[i].mName) == 0;
+
+		if (run)
+			gGroups[i].mRun();
+	}
+
+	// Correctness checks fail the run, so CI catches them
+	Uint32 numFailures = getNumFailures();
+	if (numFailures)
+		printf("%u checks failed\n", numFailures);
+
+	if (jsonPath && !writeResults(jsonPath))
+	{
+		printf("Failed to write results to %s\n", jsonPath);
+		return 1;
+	}
+
+	if (baselinePath)
+	{
+		int numRegressions = compareResults(baselinePath, threshold);
+		if (numRegressions < 0)
+		{
+			printf("Failed to read baseline %s\n", baselinePath);
+			return 1;
+		}
+
+		if (numRegressions > 0)
+		{
+			printf("%d results regressed by more than %.1f%%\n", numRegressions, threshold);
+			return 1;
+		}
+	}
+
+	return numFailures ? 1 : 0;
+}
@@ -0,0 +1,507 @@
+#include <Bench.h>
+
+#include <Core/ObjectPool.h>
+#include <Core/Variant.h>
+
+#include <Engine/Engine.h>
+#include <Engine/Resource.h>
+
+#include <UI/UI.h>
+#include <UI/UIContainer.h>
+#include <UI/TextBox.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+using namespace vne;
+
+// ============================================================================
+
+namespace
+{
+/* Times each case is run, the fastest run is reported */
+const Uint32 gNumRuns = 5;
+
+/* Summed results, so the compiler can't remove the measured work */
+Uint64 gChecksum = 0;
+
+/* Roughly the size of a small action */
+struct MicroObject
+{
+	MicroObject() : mValue(0) { }
+
+	Uint64 mValue;
+	Uint8 mPadding[56];
+};
+
+/* Resource type that doesn't need a device, pooled objects must fit a pointer */
+struct MicroResource
+{
+	MicroResource() : mValue(1) { }
+
+	Uint64 mValue;
+};
+
+/* Setup scene that only sets the default font the engine requires */
+class MicroSetup : public SetupScene
+{
+public:
+	MicroSetup(Engine* engine) :
+		SetupScene		(engine)
+	{ }
+
+private:
+	void onInit() override
+	{
+		mEngine->setDefaultFont(Resource<sf::Font>::create("micro_font"));
+	}
+
+	void gotoFirstScene() override { }
+};
+
+/* Key used for the encrypted pack */
+const Uint8 gPackKey[16] =
+{
+	0x10, 0x32, 0x54, 0x76, 0x98, 0xBA, 0xDC, 0xFE,
+	0x01, 0x23, 0x45, 0x67, 0x89, 0xAB, 0xCD, 0xEF
+};
+
+void report(const char* name, double ns)
+{
+	printf("%40s %12.2f\n", name, ns);
+	reportResult(name, ns, "ns");
+}
+
+/* Write a file, returns false if it couldn't be opened */
+bool writeFile(const std::string& path, const std::vector<Uint8>& data)
+{
+	FILE* f = fopen(path.c_str(), "wb");
+	if (!f) return false;
+
+	fwrite(&data[0], 1, data.size(), f);
+	fclose(f);
+	return true;
+}
+
+void makeDir(const char* path)
+{
+#ifdef _WIN32
+	_mkdir(path);
+#else
+	mkdir(path, 0755);
+#endif
+}
+}
+
+// ============================================================================
+
+void benchPoolPatterns()
+{
+	const Uint32 numObjects = 1000;
+
+	ObjectPool<MicroObject> pool;
+	std::vector<MicroObject*> objects(numObjects);
+
+	// Warm up the pages
+	for (Uint32 i = 0; i < numObjects; ++i)
+		objects[i] = pool.create();
+	for (Uint32 i = 0; i < numObjects; ++i)
+		pool.free(objects[i]);
+
+	report("pool/create+free pair", minTimeNs(gNumRuns, numObjects * 100, [&]()
+	{
+		for (Uint32 i = 0; i < numObjects * 100; ++i)
+		{
+			MicroObject* obj = pool.create();
+			gChecksum += obj->mValue;
+			pool.free(obj);
+		}
+	}));
+
+	report("pool/create all, free lifo", minTimeNs(gNumRuns, numObjects * 2 * 10, [&]()
+	{
+		for (Uint32 run = 0; run < 10; ++run)
+		{
+			for (Uint32 i = 0; i < numObjects; ++i)
+				objects[i] = pool.create();
+			for (Uint32 i = numObjects; i > 0; --i)
+				pool.free(objects[i - 1]);
+		}
+	}));
+
+	report("pool/create all, free fifo", minTimeNs(gNumRuns, numObjects * 2 * 10, [&]()
+	{
+		for (Uint32 run = 0; run < 10; ++run)
+		{
+			for (Uint32 i = 0; i < numObjects; ++i)
+				objects[i] = pool.create();
+			for (Uint32 i = 0; i < numObjects; ++i)
+				pool.free(objects[i]);
+		}
+	}));
+
+	report("pool/create all, reset", minTimeNs(gNumRuns, numObjects * 10, [&]()
+	{
+		for (Uint32 run = 0; run < 10; ++run)
+		{
+			for (Uint32 i = 0; i < numObjects; ++i)
+				pool.create();
+			pool.reset();
+		}
+	}));
+}
+
+// ============================================================================
+
+void benchVariant()
+{
+	const Uint32 numOps = 1000000;
+
+	std::vector<Variant> values(64);
+	NameId name("micro_name");
+
+	report("variant/assign int", minTimeNs(gNumRuns, numOps, [&]()
+	{
+		for (Uint32 i = 0; i < numOps; ++i)
+			values[i & 63] = (int)i;
+	}));
+
+	report("variant/assign float", minTimeNs(gNumRuns, numOps, [&]()
+	{
+		for (Uint32 i = 0; i < numOps; ++i)
+			values[i & 63] = (float)i;
+	}));
+
+	report("variant/assign name", minTimeNs(gNumRuns, numOps, [&]()
+	{
+		for (Uint32 i = 0; i < numOps; ++i)
+			values[i & 63] = name;
+	}));
+
+	report("variant/copy", minTimeNs(gNumRuns, numOps, [&]()
+	{
+		for (Uint32 i = 0; i < numOps; ++i)
+			values[i & 63] = values[(i + 1) & 63];
+	}));
+
+	for (Uint32 i = 0; i < values.size(); ++i)
+		values[i] = (int)(i & 3);
+
+	report("variant/compare same type", minTimeNs(gNumRuns, numOps, [&]()
+	{
+		for (Uint32 i = 0; i < numOps; ++i)
+			gChecksum += values[i & 63] == values[(i + 1) & 63];
+	}));
+
+	// Odd slots hold floats, so neighbours have different types
+	for (Uint32 i = 1; i < values.size(); i += 2)
+		values[i] = (float)(i & 3);
+
+	report("variant/compare mixed types", minTimeNs(gNumRuns, numOps, [&]()
+	{
+		for (Uint32 i = 0; i < numOps; ++i)
+			gChecksum += values[i & 63] == values[(i + 1) & 63];
+	}));
+}
+
+// ============================================================================
+
+void benchResourceGet()
+{
+	const Uint32 numNames = 256;
+	const Uint32 numOps = 1000000;
+
+	std::vector<NameId> hits, misses;
+	for (Uint32 i = 0; i < numNames; ++i)
+	{
+		hits.push_back(NameId("micro_res" + std::to_string(i)));
+		misses.push_back(NameId("micro_missing" + std::to_string(i)));
+		Resource<MicroResource>::create(hits.back());
+	}
+
+	// The first miss adds an empty entry, later misses find it
+	for (Uint32 i = 0; i < numNames; ++i)
+		Resource<MicroResource>::get(misses[i]);
+
+	report("resource/get hit", minTimeNs(gNumRuns, numOps, [&]()
+	{
+		for (Uint32 i = 0; i < numOps; ++i)
+			gChecksum += Resource<MicroResource>::get(hits[i % numNames])->mValue;
+	}));
+
+	report("resource/get miss", minTimeNs(gNumRuns, numOps, [&]()
+	{
+		for (Uint32 i = 0; i < numOps; ++i)
+			gChecksum += Resource<MicroResource>::get(misses[i % numNames]) != 0;
+	}));
+
+	Resource<MicroResource>::free();
+}
+
+// ============================================================================
+
+void benchTextLayout()
+{
+	const char* words[] = { "the ", "quick ", "brown ", "fox ", "jumps ", "over ", "lazy ", "dog " };
+	const Uint32 lengths[] = { 32, 256, 2048 };
+
+	for (Uint32 i = 0; i < sizeof(lengths) / sizeof(lengths[0]); ++i)
+	{
+		sf::String str;
+		for (Uint32 j = 0; str.getSize() < lengths[i]; ++j)
+			str += words[j % 8];
+		str = str.substring(0, lengths[i]);
+
+		for (Uint32 wrap = 0; wrap < 2; ++wrap)
+		{
+			// Word wrap is only applied once there is a string
+			TextBox box;
+			box.setString("x");
+			if (wrap)
+				box.setWordWrap(800.0f);
+
+			Uint32 numOps = 20000 / lengths[i] + 10;
+			double ns = minTimeNs(gNumRuns, numOps, [&]()
+			{
+				for (Uint32 j = 0; j < numOps; ++j)
+					box.setString(str);
+			});
+
+			std::string name = "text/applyString " + std::to_string(lengths[i]) + (wrap ? " wrapped" : "");
+			report(name.c_str(), ns);
+		}
+	}
+}
+
+// ============================================================================
+
+void benchUIRelay()
+{
+	Engine engine;
+	MicroSetup setup(&engine);
+
+	EngineParams params;
+	params.mSetupScene = &setup;
+	params.mHeadless = true;
+	if (!engine.init(params))
+	{
+		printf("Failed to start headless engine\n");
+		return;
+	}
+
+	UI ui(&engine);
+	ui.init();
+
+	// Mouse moves between two points so hover changes on every event
+	sf::Event moves[2];
+	for (Uint32 i = 0; i < 2; ++i)
+	{
+		moves[i].type = sf::Event::MouseMoved;
+		moves[i].mouseMove.x = i ? 900 : 10;
+		moves[i].mouseMove.y = i ? 500 : 10;
+	}
+
+	const Uint32 numEvents = 2000;
+	const Uint32 sizes[] = { 16, 256 };
+
+	for (Uint32 i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i)
+	{
+		// Deep tree, a chain of elements that each cover the screen
+		ui.getRoot()->removeAllChildren();
+		UIElement* parent = ui.getRoot();
+		for (Uint32 j = 0; j < sizes[i]; ++j)
+		{
+			UIContainer* element = ui.create<UIContainer>("micro_deep" + std::to_string(j));
+			element->removeAllChildren();
+			element->setSize(1920.0f, 1080.0f);
+			parent->addChild(element);
+			parent = element;
+		}
+
+		std::string name = "ui/mouse move deep " + std::to_string(sizes[i]);
+		report(name.c_str(), minTimeNs(gNumRuns, numEvents, [&]()
+		{
+			for (Uint32 j = 0; j < numEvents; ++j)
+				ui.handleEvent(moves[j & 1]);
+		}));
+
+		// Wide tree, small elements in a grid under the root
+		ui.getRoot()->removeAllChildren();
+		for (Uint32 j = 0; j < sizes[i] * 4; ++j)
+		{
+			UIContainer* element = ui.create<UIContainer>("micro_wide" + std::to_string(j));
+			element->removeAllChildren();
+			element->setSize(20.0f, 20.0f);
+			element->setPosition((float)(j % 64) * 30.0f, (float)(j / 64) * 30.0f);
+			ui.addToRoot(element);
+		}
+
+		name = "ui/mouse move wide " + std::to_string(sizes[i] * 4);
+		report(name.c_str(), minTimeNs(gNumRuns, numEvents, [&]()
+		{
+			for (Uint32 j = 0; j < numEvents; ++j)
+				ui.handleEvent(moves[j & 1]);
+		}));
+	}
+
+	ui.getRoot()->removeAllChildren();
+}
+
+// ============================================================================
+
+void benchPackedOpen()
+{
+	const Uint32 fileSize = 256 * 1024;
+
+	// Text compresses, noise is stored uncompressed
+	std::vector<Uint8> text(fileSize), noise(fileSize);
+	const char* sentence = "The quick brown fox jumps over the lazy dog. ";
+	Uint32 random = 1;
+	for (Uint32 i = 0; i < fileSize; ++i)
+	{
+		text[i] = sentence[i % 45];
+
+		random ^= random << 13;
+		random ^= random >> 17;
+		random ^= random << 5;
+		noise[i] = (Uint8)random;
+	}
+
+	makeDir("MicroBenchAssets");
+	if (!writeFile("MicroBenchAssets/text.txt", text) || !writeFile("MicroBenchAssets/noise.bin", noise))
+	{
+		printf("Failed to write pack assets\n");
+		return;
+	}
+
+	const char* packs[] = { "MicroBenchPlain.pak", "MicroBenchEncrypted.pak" };
+	const Uint8* keys[] = { 0, gPackKey };
+
+	for (Uint32 i = 0; i < 2; ++i)
+	{
+		ResourceFolder::setPath("MicroBenchAssets");
+		ResourceFolder::setKey(keys[i]);
+		ResourceFolder::pack(packs[i]);
+	}
+
+	const char* files[] = { "text.txt", "noise.bin" };
+	const char* fileNames[] = { "compressed", "stored" };
+	const Uint32 numOps = 20;
+
+	for (Uint32 i = 0; i < 2; ++i)
+	{
+		ResourceFolder::setKey(keys[i]);
+		ResourceFolder::setPath(packs[i]);
+
+		for (Uint32 j = 0; j < 2; ++j)
+		{
+			double ns = minTimeNs(gNumRuns, numOps, [&]()
+			{
+				for (Uint32 k = 0; k < numOps; ++k)
+				{
+					Uint32 size = 0;
+					Uint8* data = ResourceFolder::open(files[j], size);
+					if (data)
+						gChecksum += data[size / 2];
+					::free(data);
+				}
+			});
+
+			std::string name = std::string("pack/open 256KB ") + fileNames[j] + (keys[i] ? " encrypted" : "");
+			report(name.c_str(), ns);
+		}
+
+		// Stored entries of an unencrypted pack are views of the mapping
+		if (!keys[i])
+		{
+			report("pack/view 256KB stored", minTimeNs(gNumRuns, numOps, [&]()
+			{
+				for (Uint32 k = 0; k < numOps; ++k)
+				{
+					ResourceData data;
+					if (ResourceFolder::open(files[1], data))
+						gChecksum += data.getData()[data.getSize() / 2];
+				}
+			}));
+		}
+	}
+
+	ResourceFolder::setKey(0);
+	ResourceFolder::setPath("");
+	remove("MicroBenchAssets/text.txt");
+	remove("MicroBenchAssets/noise.bin");
+	remove(packs[0]);
+	remove(packs[1]);
+}
+
+// ============================================================================
+
+void benchPackIndex()
+{
+	const Uint32 numFiles = 2000;
+
+	// Many small files, so opening the pack is dominated by reading its index
+	makeDir("MicroBenchIndex");
+	std::vector<Uint8> data(64, 7);
+	char path[64];
+	for (Uint32 i = 0; i < numFiles; ++i)
+	{
+		sprintf(path, "MicroBenchIndex/file%u.bin", i);
+		if (!writeFile(path, data))
+		{
+			printf("Failed to write pack assets\n");
+			return;
+		}
+	}
+
+	ResourceFolder::setPath("MicroBenchIndex");
+	ResourceFolder::pack("MicroBenchIndex.pak");
+
+	report("pack/set path 2000 entries", minTimeNs(gNumRuns, 1, [&]()
+	{
+		ResourceFolder::setPath("MicroBenchIndex.pak");
+	}));
+
+	const Uint32 numOps = 10000;
+	report("pack/find entry", minTimeNs(gNumRuns, numOps, [&]()
+	{
+		sf::String name("file1234.bin");
+		for (Uint32 i = 0; i < numOps; ++i)
+			gChecksum += ResourceFolder::findPacked(name) ? 1 : 0;
+	}));
+
+	ResourceFolder::setPath("");
+	for (Uint32 i = 0; i < numFiles; ++i)
+	{
+		sprintf(path, "MicroBenchIndex/file%u.bin", i);
+		remove(path);
+	}
+	remove("MicroBenchIndex.pak");
+}
+
+// ============================================================================
+
+void runMicroBenchmarks()
+{
+	printf("Micro benchmarks (ns per operation, fastest of %u runs)\n", gNumRuns);
+
+	benchPoolPatterns();
+	benchVariant();
+	benchResourceGet();
+	benchTextLayout();
+	benchUIRelay();
+	benchPackedOpen();
+	benchPackIndex();
+
+	printf("(checksum %llu)\n\n", (unsigned long long)gChecksum);
+}
+
+// ============================================================================
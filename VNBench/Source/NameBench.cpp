@@ -0,0 +1,84 @@
+#include <Bench.h>
+
+#include <Core/NameId.h>
+
+#include <stdio.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace vne;
+
+// ============================================================================
+
+namespace
+{
+/* FNV-1a over code points, std::hash has no specialization for utf32 strings in every standard library */
+struct Utf32Hash
+{
+	size_t operator()(const std::basic_string<Uint32>& str) const
+	{
+		Uint32 hash = 2166136261u;
+		for (size_t i = 0; i < str.size(); ++i)
+			hash = (hash ^ str[i]) * 16777619u;
+
+		return hash;
+	}
+};
+}
+
+// ============================================================================
+
+void benchNameLookup()
+{
+	printf("Name lookup (ns per lookup, 256 names)\n");
+	printf("%24s %10s\n", "key", "ns");
+
+	const Uint32 numNames = 256;
+	const Uint32 numLookups = 1000000;
+
+	std::vector<std::string> names;
+	for (Uint32 i = 0; i < numNames; ++i)
+		names.push_back("resource_name_" + std::to_string(i));
+
+	std::unordered_map<std::basic_string<Uint32>, Uint32, Utf32Hash> utf32Map;
+	std::unordered_map<NameId, Uint32> nameMap;
+	std::vector<NameId> ids;
+	for (Uint32 i = 0; i < numNames; ++i)
+	{
+		utf32Map[sf::String(names[i]).toUtf32()] = i;
+		nameMap[NameId(names[i])] = i;
+		ids.push_back(NameId(names[i]));
+	}
+
+	Uint64 sum = 0;
+
+	// Old path, every lookup converts the string to a new utf32 string and hashes it
+	BenchTimer timer;
+	for (Uint32 i = 0; i < numLookups; ++i)
+		sum += utf32Map.find(sf::String(names[i % numNames].c_str()).toUtf32())->second;
+	printf("%24s %10.1f\n", "sf::String::toUtf32", timer.elapsedNs() / numLookups);
+
+	// Interning a char string at every lookup
+	timer.restart();
+	for (Uint32 i = 0; i < numLookups; ++i)
+		sum += nameMap.find(NameId(names[i % numNames].c_str()))->second;
+	printf("%24s %10.1f\n", "NameId(const char*)", timer.elapsedNs() / numLookups);
+
+	// Names interned ahead of time
+	timer.restart();
+	for (Uint32 i = 0; i < numLookups; ++i)
+		sum += nameMap.find(ids[i % numNames])->second;
+	printf("%24s %10.1f\n", "NameId", timer.elapsedNs() / numLookups);
+
+	printf("(checksum %llu)\n\n", (unsigned long long)sum);
+}
+
+// ============================================================================
+
+void runNameBenchmarks()
+{
+	benchNameLookup();
+}
+
+// ============================================================================
@@ -0,0 +1,418 @@
+#include <Bench.h>
+
+#include <Core/ObjectPool.h>
+#include <Core/LinearArena.h>
+#include <Core/MemoryResource.h>
+#include <Core/TypeSlot.h>
+
+#include <stdio.h>
+#include <functional>
+#include <string>
+#include <vector>
+
+using namespace vne;
+
+// ============================================================================
+
+namespace
+{
+
+/* Roughly the size of a small action */
+struct PoolObject
+{
+	PoolObject() : mValue(0) { }
+
+	Uint64 mValue;
+	Uint8 mPadding[56];
+};
+
+/* Stand ins for the script actions a scene creates */
+struct BenchAction
+{
+	virtual ~BenchAction() { }
+
+	std::function<bool()> mCondition;
+	bool mIsComplete = false;
+};
+
+struct BenchDialogue : public BenchAction
+{
+	std::string mName;
+	std::string mDialogue;
+	float mTextSpeed = 600.0f;
+};
+
+struct BenchTransform : public BenchAction
+{
+	float mValues[6] = { };
+};
+
+struct BenchClipShape
+{
+	float mValues[24];
+};
+
+/* Scene::alloc in pooled mode */
+template <typename T>
+T* poolAlloc(std::vector<IObjectPool*>& pools)
+{
+	Uint32 slot = TypeSlot::get<T>();
+	if (slot >= pools.size())
+		pools.resize(slot + 1, 0);
+
+	IObjectPool*& pool = pools[slot];
+	if (!pool)
+		pool = new ObjectPool<T>();
+
+	return ((ObjectPool<T>*)pool)->create();
+}
+
+}
+
+// ============================================================================
+
+void benchPoolFree()
+{
+	printf("ObjectPool::free vs pool size\n");
+	printf("%10s %14s\n", "objects", "ns/free");
+
+	const Uint32 numObjects[] = { 128, 1024, 8192, 65536, 524288 };
+
+	for (Uint32 n : numObjects)
+	{
+		ObjectPool<PoolObject> pool;
+		std::vector<PoolObject*> objects;
+
+		// Fill the pool, every 128 objects is at least one page
+		while (objects.size() < n)
+			objects.push_back(pool.create());
+
+		// Free the newest objects, these used to be the slowest to find
+		Uint32 numFree = (Uint32)objects.size() / 2;
+		BenchTimer timer;
+		for (Uint32 i = 0; i < numFree; ++i)
+		{
+			pool.free(objects.back());
+			objects.pop_back();
+		}
+		double ns = timer.elapsedNs();
+
+		printf("%10u %14.2f\n", n, ns / numFree);
+	}
+
+	printf("\n");
+}
+
+// ============================================================================
+
+void benchPoolChurn()
+{
+	printf("ObjectPool free + create churn on a full pool\n");
+	printf("%10s %14s\n", "objects", "ns/op");
+
+	const Uint32 numObjects[] = { 128, 1024, 8192, 65536, 524288 };
+
+	for (Uint32 n : numObjects)
+	{
+		ObjectPool<PoolObject> pool;
+		std::vector<PoolObject*> objects;
+
+		while (objects.size() < n)
+			objects.push_back(pool.create());
+
+		// Free an object from an old page and create a new one, so the free slot is never on the newest page
+		const Uint32 numOps = 100000;
+		Uint32 index = 0;
+		BenchTimer timer;
+		for (Uint32 i = 0; i < numOps; ++i)
+		{
+			index = (index + 7919) % n;
+			pool.free(objects[index]);
+			objects[index] = pool.create();
+		}
+		double ns = timer.elapsedNs();
+
+		printf("%10u %14.2f\n", n, ns / numOps);
+	}
+
+	printf("\n");
+}
+
+// ============================================================================
+
+void benchPoolReuse()
+{
+	printf("ObjectPool refill after free() vs reset()\n");
+	printf("%10s %14s %14s\n", "objects", "free ns/obj", "reset ns/obj");
+
+	const Uint32 numObjects[] = { 1024, 8192, 65536 };
+
+	for (Uint32 n : numObjects)
+	{
+		ObjectPool<PoolObject> pool;
+		double times[2];
+
+		for (int mode = 0; mode < 2; ++mode)
+		{
+			// First run allocates all pages
+			for (Uint32 i = 0; i < n; ++i)
+				pool.create();
+
+			BenchTimer timer;
+
+			// Release pages or keep them, then run through the "scene" again
+			if (mode == 0)
+				pool.free();
+			else
+				pool.reset();
+
+			for (Uint32 i = 0; i < n; ++i)
+				pool.create();
+
+			times[mode] = timer.elapsedNs();
+			pool.free();
+		}
+
+		printf("%10u %14.2f %14.2f\n", n, times[0] / n, times[1] / n);
+	}
+
+	printf("\n");
+}
+
+// ============================================================================
+
+void benchSceneBuild()
+{
+	printf("Build and clean up a 10k action scene (ms per run)\n");
+	printf("%10s %14s %14s\n", "run", "pooled", "linear");
+
+	const Uint32 numActions = 10000;
+	std::vector<IObjectPool*> pools;
+	LinearArena arena;
+
+	for (Uint32 run = 0; run < 3; ++run)
+	{
+		double times[2];
+
+		// Pooled memory mode
+		BenchTimer timer;
+		for (Uint32 i = 0; i < numActions; ++i)
+		{
+			if (i % 3 == 0)
+				poolAlloc<BenchDialogue>(pools)->mDialogue = "The quick brown fox jumps over the lazy dog.";
+			else if (i % 3 == 1)
+				poolAlloc<BenchTransform>(pools);
+			else
+				poolAlloc<BenchClipShape>(pools);
+		}
+		for (Uint32 i = 0; i < pools.size(); ++i)
+		{
+			if (pools[i])
+				pools[i]->reset();
+		}
+		times[0] = timer.elapsedNs();
+
+		// Linear memory mode
+		timer.restart();
+		for (Uint32 i = 0; i < numActions; ++i)
+		{
+			if (i % 3 == 0)
+				arena.create<BenchDialogue>()->mDialogue = "The quick brown fox jumps over the lazy dog.";
+			else if (i % 3 == 1)
+				arena.create<BenchTransform>();
+			else
+				arena.create<BenchClipShape>();
+		}
+		arena.reset();
+		times[1] = timer.elapsedNs();
+
+		printf("%10u %14.3f %14.3f\n", run, times[0] * 1.0e-6, times[1] * 1.0e-6);
+	}
+
+	for (Uint32 i = 0; i < pools.size(); ++i)
+		delete pools[i];
+
+	printf("\n");
+}
+
+// ============================================================================
+
+void benchScenePrewarm()
+{
+	printf("First build of a 10k action scene with fresh pools (ms per run)\n");
+	printf("%10s %14s %14s\n", "run", "cold", "prewarmed");
+
+	const Uint32 numActions = 10000;
+
+	for (Uint32 run = 0; run < 3; ++run)
+	{
+		double times[2];
+
+		for (Uint32 prewarm = 0; prewarm < 2; ++prewarm)
+		{
+			std::vector<IObjectPool*> pools;
+
+			BenchTimer timer;
+
+			// Reserve the peak counts a previous run would have recorded
+			if (prewarm)
+			{
+				poolAlloc<BenchDialogue>(pools);
+				poolAlloc<BenchTransform>(pools);
+				poolAlloc<BenchClipShape>(pools);
+
+				pools[TypeSlot::get<BenchDialogue>()]->reserve(numActions / 3 + 1);
+				pools[TypeSlot::get<BenchTransform>()]->reserve(numActions / 3 + 1);
+				pools[TypeSlot::get<BenchClipShape>()]->reserve(numActions / 3 + 1);
+			}
+
+			for (Uint32 i = 0; i < numActions; ++i)
+			{
+				if (i % 3 == 0)
+					poolAlloc<BenchDialogue>(pools)->mDialogue = "The quick brown fox jumps over the lazy dog.";
+				else if (i % 3 == 1)
+					poolAlloc<BenchTransform>(pools);
+				else
+					poolAlloc<BenchClipShape>(pools);
+			}
+			times[prewarm] = timer.elapsedNs();
+
+			for (Uint32 i = 0; i < pools.size(); ++i)
+				delete pools[i];
+		}
+
+		printf("%10u %14.3f %14.3f\n", run, times[0] * 1.0e-6, times[1] * 1.0e-6);
+	}
+
+	printf("\n");
+}
+
+// ============================================================================
+
+/* Build a scene's action list and 500 groups of 20 child actions */
+template <typename Vector>
+void buildActionLists(MemoryResource* resource, BenchAction* action)
+{
+	Vector actions(resource);
+	std::vector<Vector> groups;
+	groups.reserve(500);
+
+	for (Uint32 i = 0; i < 500; ++i)
+	{
+		groups.emplace_back(resource);
+		actions.push_back(action);
+
+		for (Uint32 j = 0; j < 20; ++j)
+			groups.back().push_back(action);
+	}
+}
+
+void benchSceneContainers()
+{
+	printf("Build and tear down scene action lists (ms per run)\n");
+	printf("%10s %14s %14s %14s\n", "run", "heap", "pool resource", "arena resource");
+
+	BenchAction action;
+	PoolResource poolResource;
+	LinearArena arena;
+	ArenaResource arenaResource(&arena);
+
+	for (Uint32 run = 0; run < 3; ++run)
+	{
+		double times[3];
+
+		BenchTimer timer;
+		for (Uint32 i = 0; i < 20; ++i)
+			buildActionLists<ResourceVector<BenchAction*>>(getDefaultResource(), &action);
+		times[0] = timer.elapsedNs();
+
+		timer.restart();
+		for (Uint32 i = 0; i < 20; ++i)
+			buildActionLists<ResourceVector<BenchAction*>>(&poolResource, &action);
+		times[1] = timer.elapsedNs();
+
+		timer.restart();
+		for (Uint32 i = 0; i < 20; ++i)
+		{
+			buildActionLists<ResourceVector<BenchAction*>>(&arenaResource, &action);
+			arena.reset();
+		}
+		times[2] = timer.elapsedNs();
+
+		printf("%10u %14.3f %14.3f %14.3f\n", run, times[0] * 1.0e-6 / 20, times[1] * 1.0e-6 / 20, times[2] * 1.0e-6 / 20);
+	}
+
+	printf("\n");
+}
+
+// ============================================================================
+
+void benchPoolIterate()
+{
+	printf("Iterating live objects with half the pool freed\n");
+	printf("%10s %14s %14s %14s\n", "objects", "ns/obj vector", "ns/obj forEach", "ns/obj range");
+
+	const Uint32 numObjects[] = { 1024, 65536, 524288 };
+
+	for (Uint32 n : numObjects)
+	{
+		ObjectPool<PoolObject> pool;
+		std::vector<PoolObject*> objects;
+
+		for (Uint32 i = 0; i < n; ++i)
+			objects.push_back(pool.create());
+
+		// Free every other object so the pool has holes
+		std::vector<PoolObject*> live;
+		for (Uint32 i = 0; i < n; ++i)
+		{
+			if (i & 1)
+				pool.free(objects[i]);
+			else
+				live.push_back(objects[i]);
+		}
+
+		// Shuffle the pointer list the way a vector of mixed allocations ends up
+		for (Uint32 i = (Uint32)live.size() - 1; i > 0; --i)
+			std::swap(live[i], live[(i * 2654435761u) % (i + 1)]);
+
+		Uint64 sum = 0;
+
+		BenchTimer timer;
+		for (PoolObject* object : live)
+			sum += ++object->mValue;
+		double vectorNs = timer.elapsedNs();
+
+		timer.restart();
+		pool.forEach([&](PoolObject* object) { sum += ++object->mValue; });
+		double forEachNs = timer.elapsedNs();
+
+		timer.restart();
+		for (PoolObject& object : pool)
+			sum += ++object.mValue;
+		double rangeNs = timer.elapsedNs();
+
+		// Every live object was visited once per loop
+		if (sum != (Uint64)live.size() * 6)
+			printf("iteration mismatch\n");
+
+		printf("%10u %14.2f %14.2f %14.2f\n", n, vectorNs / live.size(), forEachNs / live.size(), rangeNs / live.size());
+	}
+
+	printf("\n");
+}
+
+// ============================================================================
+
+void runPoolBenchmarks()
+{
+	benchPoolFree();
+	benchPoolChurn();
+	benchPoolReuse();
+	benchSceneBuild();
+	benchScenePrewarm();
+	benchSceneContainers();
+	benchPoolIterate();
+}
+
+// ============================================================================
@@ -0,0 +1,169 @@
+#include <Bench.h>
+#include <StressScene.h>
+
+#include <Engine/Engine.h>
+#include <Engine/HeadlessRunner.h>
+#include <Engine/Resource.h>
+
+#include <stdio.h>
+
+using namespace vne;
+
+// ============================================================================
+
+namespace
+{
+/* Frames run to measure per frame cost */
+const Uint32 gNumFrames = 120;
+
+/* Frames between clicks that advance dialogue */
+const Uint32 gClickInterval = 4;
+
+/* Setup scene that only sets the default font the engine requires */
+class StressSetup : public SetupScene
+{
+public:
+	StressSetup(Engine* engine) :
+		SetupScene		(engine)
+	{ }
+
+private:
+	void onInit() override
+	{
+		// Fonts aren't used in headless mode, so an empty one is enough
+		mEngine->setDefaultFont(Resource<sf::Font>::create("stress_font"));
+	}
+
+	void gotoFirstScene() override { }
+};
+
+/* Measurements of one stress scene */
+struct StressResult
+{
+	double mBuildMs;
+	double mUpdateUs;
+	double mRenderUs;
+	Uint32 mArenaKb;
+	Uint64 mPeakKb;
+};
+
+/* Run a generated scene in its own engine and measure it */
+bool runScene(const StressParams& params, StressResult& result)
+{
+	// The process peak never goes down, so only the amount this run raised it is reported
+	Uint64 startPeak = HeadlessRunner::getPeakMemory();
+
+	{
+		Engine engine;
+		StressSetup setup(&engine);
+
+		EngineParams engineParams;
+		engineParams.mSetupScene = &setup;
+		engineParams.mHeadless = true;
+		if (!engine.init(engineParams))
+			return false;
+
+		// The setup scene deletes the scene along with the rest of the engine's scenes
+		StressScene* scene = new StressScene(&engine, params);
+		engine.addScene("stress", scene);
+		engine.gotoScene("stress");
+
+		// The scene is generated when the engine switches to it, this also runs the first frame
+		BenchTimer timer;
+		engine.step(0.0f);
+		result.mBuildMs = timer.elapsedNs() * 1.0e-6;
+
+		sf::Event press;
+		press.type = sf::Event::MouseButtonPressed;
+		press.mouseButton.button = sf::Mouse::Left;
+		press.mouseButton.x = 0;
+		press.mouseButton.y = 0;
+
+		sf::Event release = press;
+		release.type = sf::Event::MouseButtonReleased;
+
+		double updateNs = 0.0, renderNs = 0.0;
+		for (Uint32 i = 0; i < gNumFrames; ++i)
+		{
+			if (i % gClickInterval == 0)
+			{
+				engine.handleEvent(press);
+				engine.handleEvent(release);
+			}
+
+			timer.restart();
+			scene->update(1.0f / 60.0f);
+			updateNs += timer.elapsedNs();
+
+			timer.restart();
+			scene->render();
+			renderNs += timer.elapsedNs();
+		}
+
+		result.mUpdateUs = updateNs * 1.0e-3 / gNumFrames;
+		result.mRenderUs = renderNs * 1.0e-3 / gNumFrames;
+		result.mArenaKb = scene->getArenaUsed() / 1024;
+		result.mPeakKb = (HeadlessRunner::getPeakMemory() - startPeak) / 1024;
+	}
+
+	// The engine only frees resources at the end of run, so the next scene starts without them
+	Resource<sf::Texture>::free();
+	Resource<sf::Font>::free();
+	Resource<sf::SoundBuffer>::free();
+	Resource<sf::Music>::free();
+
+	return true;
+}
+}
+
+// ============================================================================
+
+void benchStressScenes()
+{
+	printf("Generated stress scenes, headless (build ms, update / render us per frame, arena KB, peak process growth KB)\n");
+	printf("%12s %8s %10s %10s %10s %10s %10s\n", "scaled", "count", "build", "update", "render", "arena", "peak +");
+
+	// Scale one count at a time, each scene runs in a fresh engine
+	const char* names[] = { "lines", "images", "groups", "animations", "elements", "characters" };
+	const Uint32 counts[] = { 100, 1000, 10000, 100000 };
+
+	for (Uint32 i = 0; i < sizeof(names) / sizeof(names[0]); ++i)
+	{
+		for (Uint32 j = 0; j < sizeof(counts) / sizeof(counts[0]); ++j)
+		{
+			StressParams stress;
+			Uint32* count[] =
+			{
+				&stress.mNumLines,
+				&stress.mNumImages,
+				&stress.mNumGroups,
+				&stress.mNumAnimations,
+				&stress.mNumElements,
+				&stress.mNumCharacters
+			};
+			*count[i] = counts[j];
+
+			StressResult result;
+			if (!runScene(stress, result))
+			{
+				printf("Failed to start headless engine\n\n");
+				return;
+			}
+
+			printf("%12s %8u %10.2f %10.2f %10.2f %10u %10llu\n",
+				names[i], counts[j], result.mBuildMs, result.mUpdateUs, result.mRenderUs,
+				result.mArenaKb, (unsigned long long)result.mPeakKb);
+		}
+	}
+
+	printf("\n");
+}
+
+// ============================================================================
+
+void runStressBenchmarks()
+{
+	benchStressScenes();
+}
+
+// ============================================================================
@@ -0,0 +1,168 @@
+#include <StressScene.h>
+
+#include <Engine/Engine.h>
+
+#include <functional>
+
+using namespace vne;
+
+// ============================================================================
+
+namespace
+{
+/* Number of image labels each character has */
+const Uint32 gNumPoses = 4;
+}
+
+// ============================================================================
+// ============================================================================
+
+StressParams::StressParams() :
+	mNumLines		(100),
+	mNumCharacters	(4),
+	mNumImages		(20),
+	mNumGroups		(10),
+	mGroupSize		(4),
+	mNumAnimations	(10),
+	mNumElements	(10),
+	mTreeWidth		(8),
+	mSeed			(1)
+{
+
+}
+
+// ============================================================================
+// ============================================================================
+
+StressScene::StressScene(Engine* engine, const StressParams& params) :
+	NovelScene		(engine),
+	mParams			(params),
+	mRandom			(params.mSeed ? params.mSeed : 1)
+{
+	for (Uint32 i = 0; i < mParams.mNumCharacters; ++i)
+	{
+		sf::String name = "stress_c" + std::to_string(i);
+		mCharacters.push_back(name);
+
+		// Images are labels without textures, since textures aren't loaded in headless mode
+		Character character(name);
+		for (Uint32 j = 0; j < gNumPoses; ++j)
+			character.addImage(NameId("pose" + std::to_string(j)), 0);
+
+		mEngine->addCharacter(character);
+	}
+}
+
+Uint32 StressScene::getArenaUsed() const
+{
+	return mArena.getUsedSize();
+}
+
+// ============================================================================
+
+void StressScene::onInit()
+{
+	addElements();
+	addAnimations();
+
+	// Shuffle lines, image changes, and groups together, weighted by how many of each are left
+	Uint32 numLines = mParams.mNumLines;
+	Uint32 numImages = mParams.mNumCharacters ? mParams.mNumImages : 0;
+	Uint32 numGroups = mParams.mNumCharacters ? mParams.mNumGroups : 0;
+
+	while (numLines + numImages + numGroups)
+	{
+		Uint32 r = random(numLines + numImages + numGroups);
+
+		if (r < numLines)
+		{
+			sf::String line = "Line " + std::to_string(numLines) + ", the quick brown fox jumps over the lazy dog.";
+			if (mCharacters.empty())
+				narrate(line);
+			else
+				mEngine->getCharacter(mCharacters[random((Uint32)mCharacters.size())]).say(line);
+			--numLines;
+		}
+		else if (r < numLines + numImages)
+		{
+			Character& character = mEngine->getCharacter(mCharacters[random((Uint32)mCharacters.size())]);
+			character.show(NameId("pose" + std::to_string(random(gNumPoses))), Transition::Fade, 0.2f);
+			--numImages;
+		}
+		else
+		{
+			addGroup();
+			--numGroups;
+		}
+	}
+}
+
+// ============================================================================
+
+void StressScene::addElements()
+{
+	mElements.clear();
+
+	const sf::Vector2f& viewSize = mEngine->getView().getSize();
+	Uint32 width = mParams.mTreeWidth ? mParams.mTreeWidth : 1;
+
+	for (Uint32 i = 0; i < mParams.mNumElements; ++i)
+	{
+		// Elements are shared resources, so later scenes reuse them by name
+		ImageBox* element = mUI.create<ImageBox>("stress_e" + std::to_string(i));
+		element->removeAllChildren();
+		element->setSize(40.0f, 40.0f);
+		element->setPosition((float)random((Uint32)viewSize.x), (float)random((Uint32)viewSize.y));
+		element->setColor(sf::Color(random(256), random(256), random(256)));
+
+		// The first row is added to the root, the rest fill the tree breadth first
+		if (i < width)
+			mUI.addToRoot(element);
+		else
+			mElements[(i - width) / width]->addChild(element);
+
+		mElements.push_back(element);
+	}
+}
+
+void StressScene::addAnimations()
+{
+	for (Uint32 i = 0; i < mParams.mNumAnimations; ++i)
+	{
+		UIElement* element = mElements.empty() ? (UIElement*)mDialogueBox : mElements[i % mElements.size()];
+
+		FloatAnimation* anim = alloc<FloatAnimation>(
+			std::bind(&UIElement::setRotation, element, std::placeholders::_1),
+			0.0f, 360.0f,
+			1.0f + random(4)
+			);
+		addAnimation(anim);
+	}
+}
+
+void StressScene::addGroup()
+{
+	startGroup(true);
+
+	for (Uint32 i = 0; i < mParams.mGroupSize; ++i)
+	{
+		Character& character = mEngine->getCharacter(mCharacters[random((Uint32)mCharacters.size())]);
+		character.move(sf::Vector2f((float)random(1920), (float)random(1080)), 0.5f);
+	}
+
+	endGroup();
+}
+
+// ============================================================================
+
+Uint32 StressScene::random(Uint32 max)
+{
+	// Xorshift
+	mRandom ^= mRandom << 13;
+	mRandom ^= mRandom >> 17;
+	mRandom ^= mRandom << 5;
+
+	return max ? mRandom % max : 0;
+}
+
+// ============================================================================
@@ -0,0 +1,125 @@
+#ifndef VN_BENCH_STRESS_SCENE_H
+#define VN_BENCH_STRESS_SCENE_H
+
+#include <Engine/Scene.h>
+
+#include <vector>
+
+// ============================================================================
+
+/// <summary>
+/// Sizes of a generated stress scene
+/// </summary>
+struct StressParams
+{
+	StressParams();
+
+	/// <summary>
+	/// Number of dialogue lines
+	/// </summary>
+	vne::Uint32 mNumLines;
+
+	/// <summary>
+	/// Number of characters, dialogue lines are spread over them
+	/// </summary>
+	vne::Uint32 mNumCharacters;
+
+	/// <summary>
+	/// Number of character image changes
+	/// </summary>
+	vne::Uint32 mNumImages;
+
+	/// <summary>
+	/// Number of parallel action groups
+	/// </summary>
+	vne::Uint32 mNumGroups;
+
+	/// <summary>
+	/// Number of actions in each group
+	/// </summary>
+	vne::Uint32 mGroupSize;
+
+	/// <summary>
+	/// Number of animations started with the scene
+	/// </summary>
+	vne::Uint32 mNumAnimations;
+
+	/// <summary>
+	/// Number of extra UI elements
+	/// </summary>
+	vne::Uint32 mNumElements;
+
+	/// <summary>
+	/// Number of children of each extra UI element, so the elements form a tree
+	/// </summary>
+	vne::Uint32 mTreeWidth;
+
+	/// <summary>
+	/// Seed used to order the script and place elements
+	/// </summary>
+	vne::Uint32 mSeed;
+};
+
+// ============================================================================
+
+/// <summary>
+/// Novel scene generated from stress params.
+/// Script actions are shuffled together with a fixed seed, so the same params always build the same scene
+/// </summary>
+class StressScene : public vne::NovelScene
+{
+public:
+	/// <summary>
+	/// Create the scene, and add its characters to the engine.
+	/// Characters have to exist before the engine switches to the scene
+	/// </summary>
+	/// <param name="engine">Engine</param>
+	/// <param name="params">Scene sizes</param>
+	StressScene(vne::Engine* engine, const StressParams& params);
+
+	/// <summary>
+	/// Get the number of bytes used in the scene's arena
+	/// </summary>
+	/// <returns>Bytes used</returns>
+	vne::Uint32 getArenaUsed() const;
+
+private:
+	void onInit() override;
+
+	/* Add extra UI elements in a tree under the root */
+	void addElements();
+
+	/* Add animations that rotate the extra elements */
+	void addAnimations();
+
+	/* Add a parallel group of character moves */
+	void addGroup();
+
+	/* Get a random number less than max */
+	vne::Uint32 random(vne::Uint32 max);
+
+private:
+	/// <summary>
+	/// Scene sizes
+	/// </summary>
+	StressParams mParams;
+
+	/// <summary>
+	/// Character names
+	/// </summary>
+	std::vector<sf::String> mCharacters;
+
+	/// <summary>
+	/// Extra UI elements
+	/// </summary>
+	std::vector<vne::UIElement*> mElements;
+
+	/// <summary>
+	/// Random state
+	/// </summary>
+	vne::Uint32 mRandom;
+};
+
+// ============================================================================
+
+#endif
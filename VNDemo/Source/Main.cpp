@@ -1,11 +1,16 @@
 #include <vld.h>
 
+#include <Core/FrameProfiler.h>
+
 #include <Engine/Engine.h>
+#include <Engine/HeadlessRunner.h>
 #include <Engine/Resource.h>
 
 #include <Setup.h>
 
 #include <iostream>
+#include <stdlib.h>
+#include <string.h>
 
 using namespace vne;
 
@@ -33,8 +38,38 @@ Uint8 gResourceKey[] =
 
 // ============================================================================
 
-int main()
+/* Play through the demo without a window, clicking to advance dialogue */
+int runHeadless(Engine& engine, float maxTime)
+{
+	HeadlessRunner runner(&engine);
+	runner.addClicks(0.5f, 0.5f, (Uint32)(maxTime / 0.5f));
+
+	HeadlessStats stats = runner.run(maxTime);
+
+	std::cout <<
+		"frames: " << stats.mNumFrames << "\n" <<
+		"sim time: " << stats.mSimTime << " s\n" <<
+		"wall time: " << stats.mWallTime << " s\n" <<
+		"actions: " << stats.mNumActions << " (" << stats.getActionsPerSecond() << " / s)\n" <<
+		"pool allocs: " << stats.mNumAllocs << "\n" <<
+		"peak memory: " << stats.mPeakMemory / 1024 << " KB\n";
+
+	return stats.mFinished ? 0 : 1;
+}
+
+// ============================================================================
+
+int main(int argc, char** argv)
 {
+	// Usage: VNDemo [--headless [max seconds]] [--profile]
+	bool headless = argc > 1 && strcmp(argv[1], "--headless") == 0;
+	float maxTime = argc > 2 && argv[2][0] != '-' ? (float)atof(argv[2]) : 600.0f;
+
+	// Show the frame time graph and write the last frames when the demo exits
+	bool profile = false;
+	for (int i = 1; i < argc; ++i)
+		profile = profile || strcmp(argv[i], "--profile") == 0;
+
 	ResourceFolder::setKey(gResourceKey);
 	ResourceFolder::setPath("Assets");
 
@@ -47,10 +82,23 @@ int main()
 	params.mWindowTitle = "VN Demo";
 	params.mFullscreen = false;
 	params.mSetupScene = &setup;
+	params.mHeadless = headless;
+	params.mShowProfileGraph = profile;
 
 	bool success = engine.init(params);
-	if (success)
+	if (!success) return 1;
+
+	int result = 0;
+	if (headless)
+		result = runHeadless(engine, maxTime);
+	else
 		engine.run();
 
-	return 0;
+	if (profile)
+	{
+		FrameProfiler::writeCsv("FrameProfile.csv");
+		FrameProfiler::writeTrace("FrameTrace.json");
+	}
+
+	return result;
 }
\ No newline at end of file
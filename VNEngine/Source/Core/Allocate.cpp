@@ -2,20 +2,94 @@
 
 #include <cstdlib>
 
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
 using namespace vne;
 
 ///////////////////////////////////////////////////////////////////////////////
 
-void* vne::aligned_alloc(Uint32 size, Uint32 align)
+namespace
+{
+/* Stored right before the aligned memory */
+struct AllocHeader
+{
+	/* Start of the underlying allocation */
+	void* mBase;
+	/* Size of the mapping, or 0 if the memory came from malloc */
+	size_t mMapSize;
+};
+
+/* Size of a transparent huge page */
+const size_t gHugePageSize = 2 * 1024 * 1024;
+
+AllocFailHandler gAllocFailHandler = 0;
+
+/* Report failure and return null */
+void* allocFailed(size_t size, size_t align)
+{
+	if (gAllocFailHandler)
+		gAllocFailHandler(size, align);
+
+	return 0;
+}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void* vne::aligned_alloc(size_t size, size_t align, Uint32 flags)
 {
+	// The header needs pointer alignment
+	if (align < alignof(AllocHeader))
+		align = alignof(AllocHeader);
+
 	// Max offset of memory
-	Uint32 offset = sizeof(void*) + align - 1;
+	size_t offset = sizeof(AllocHeader) + align - 1;
+	if (size > (size_t)-1 - offset)
+		return allocFailed(size, align);
+
+#ifdef __linux__
+	// Large allocations get their own mapping, aligned to huge pages so the kernel can back them with THP
+	if ((flags & AllocLargePages) && size >= gHugePageSize)
+	{
+		size_t mapAlign = align > gHugePageSize ? align : gHugePageSize;
+		if (size > (size_t)-1 - sizeof(AllocHeader) - mapAlign)
+			return allocFailed(size, align);
+
+		size_t mapSize = size + sizeof(AllocHeader) + mapAlign;
+
+		void* ptr = mmap(0, mapSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (ptr == MAP_FAILED)
+			return allocFailed(size, align);
+
+		// Start the memory on a huge page boundary, the header goes at the end of the page before it
+		void* start = (void*)(((Uint64)ptr + sizeof(AllocHeader) + mapAlign - 1) & ~(Uint64)(mapAlign - 1));
+		madvise(start, size, MADV_HUGEPAGE);
+
+		AllocHeader* header = (AllocHeader*)start - 1;
+		header->mBase = ptr;
+		header->mMapSize = mapSize;
+
+		return start;
+	}
+#endif
 
 	void* ptr = malloc(size + offset);
+	if (!ptr)
+		return allocFailed(size, align);
+
 	// Calculate start of usable memory
-	void** start = (void**)(((Uint64)ptr + offset) & ~(align - 1));
+	void* start = (void*)(((Uint64)ptr + offset) & ~(Uint64)(align - 1));
+
 	// Mark start of allocated memory
-	start[-1] = ptr;
+	AllocHeader* header = (AllocHeader*)start - 1;
+	header->mBase = ptr;
+	header->mMapSize = 0;
 
 	return start;
 }
@@ -26,8 +100,58 @@ void vne::aligned_free(void* ptr)
 {
 	if (!ptr) return;
 
+	AllocHeader* header = (AllocHeader*)ptr - 1;
+
+#ifdef __linux__
+	if (header->mMapSize)
+	{
+		munmap(header->mBase, header->mMapSize);
+		return;
+	}
+#endif
+
 	// Free start of allocated memory
-	free(((void**)ptr)[-1]);
+	free(header->mBase);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void* vne::page_alloc(size_t size, size_t align)
+{
+	if (align < sizeof(void*))
+		align = sizeof(void*);
+
+	// Let the system allocator align the block, padding it here would double the cost of self aligned pages
+#ifdef _WIN32
+	void* ptr = _aligned_malloc(size, align);
+#else
+	void* ptr = 0;
+	if (posix_memalign(&ptr, align, size))
+		ptr = 0;
+#endif
+
+	if (!ptr)
+		return allocFailed(size, align);
+
+	return ptr;
 }
 
-///////////////////////////////////////////////////////////////////////////////
\ No newline at end of file
+///////////////////////////////////////////////////////////////////////////////
+
+void vne::page_free(void* ptr)
+{
+#ifdef _WIN32
+	_aligned_free(ptr);
+#else
+	free(ptr);
+#endif
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void vne::set_alloc_fail_handler(AllocFailHandler handler)
+{
+	gAllocFailHandler = handler;
+}
+
+///////////////////////////////////////////////////////////////////////////////
@@ -3,18 +3,40 @@
 
 #include <Core/DataTypes.h>
 
+#include <stddef.h>
+
 namespace vne
 {
 
 // ============================================================================
 
-/* Aligned memory allocation */
-void* aligned_alloc(Uint32 size, Uint32 align = 4);
+/* Aligned allocation flags */
+enum AllocFlags
+{
+	/* Regular heap allocation */
+	AllocDefault = 0,
+	/* Back large allocations with huge pages where the platform supports it (mmap + THP on Linux) */
+	AllocLargePages = 1 << 0
+};
+
+/* Called when an allocation fails, before null is returned */
+typedef void(*AllocFailHandler)(size_t size, size_t align);
+
+/* Aligned memory allocation, align must be a power of two (any size, including above the OS page size).
+   Returns null if the allocation fails */
+void* aligned_alloc(size_t size, size_t align = 4, Uint32 flags = AllocDefault);
 /* Free allocated memory */
 void aligned_free(void* ptr);
+/* Allocate memory aligned to a large power of two (such as its own size) without a header or padding.
+   Returns null if the allocation fails, memory must be freed with page_free */
+void* page_alloc(size_t size, size_t align);
+/* Free memory allocated with page_alloc */
+void page_free(void* ptr);
+/* Set the function that is called when an allocation fails */
+void set_alloc_fail_handler(AllocFailHandler handler);
 
 // ============================================================================
 
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,525 @@
+#include <Core/Condition.h>
+
+#include <ctype.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+using namespace vne;
+
+///////////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+/* Results of logic and comparison ops are pushed as pointers to these */
+const Variant gTrue(true);
+const Variant gFalse(false);
+
+const Variant* toVariant(bool val)
+{
+	return val ? &gTrue : &gFalse;
+}
+
+/* Numbers are true if they aren't zero, names are true if they aren't empty */
+bool isTrue(const Variant& val)
+{
+	if (val.isNumeric())
+		return val.get<double>() != 0.0;
+	return val.getNameId() != 0;
+}
+
+/* Only numbers can be ordered */
+int compare(const Variant& a, const Variant& b, bool& ordered)
+{
+	ordered = a.isNumeric() && b.isNumeric();
+	if (!ordered) return 0;
+
+	double x = a.get<double>();
+	double y = b.get<double>();
+	return x < y ? -1 : (x > y ? 1 : 0);
+}
+
+bool isIdentStart(char c)
+{
+	return isalpha((Uint8)c) || c == '_';
+}
+
+bool isIdentChar(char c)
+{
+	return isalnum((Uint8)c) || c == '_' || c == '.';
+}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+/* Recursive descent parser that emits bytecode while parsing */
+class Condition::Parser
+{
+public:
+	Parser(Condition* cond, const char* expr) :
+		mCond		(cond),
+		mExpr		(expr),
+		mPos		(expr),
+		mNesting	(0)
+	{ }
+
+	bool parse()
+	{
+		parseOr();
+		skipSpace();
+		if (!mCond->mError && *mPos)
+			fail("Unexpected character");
+
+		return !mCond->mError;
+	}
+
+private:
+	void parseOr()
+	{
+		parseAnd();
+		while (!mCond->mError && (match("||") || matchWord("or")))
+		{
+			parseAnd();
+			mCond->emit(Or);
+		}
+	}
+
+	void parseAnd()
+	{
+		parseCompare();
+		while (!mCond->mError && (match("&&") || matchWord("and")))
+		{
+			parseCompare();
+			mCond->emit(And);
+		}
+	}
+
+	void parseCompare()
+	{
+		parseUnary();
+		if (mCond->mError) return;
+
+		// Two character operators have to be checked first
+		Op op = NumOps;
+		if (match("==")) op = Equal;
+		else if (match("!=")) op = NotEqual;
+		else if (match("<=")) op = LessEqual;
+		else if (match(">=")) op = GreaterEqual;
+		else if (match("<")) op = Less;
+		else if (match(">")) op = Greater;
+
+		if (op != NumOps)
+		{
+			parseUnary();
+			mCond->emit(op);
+		}
+	}
+
+	void parseUnary()
+	{
+		// Every nested operand passes through here, so this bounds the recursion
+		if (mNesting >= MaxStack)
+		{
+			fail("Expression is too deep");
+			return;
+		}
+
+		++mNesting;
+
+		if (match("!") || matchWord("not"))
+		{
+			parseUnary();
+			mCond->emit(Not);
+		}
+		else
+			parsePrimary();
+
+		--mNesting;
+	}
+
+	void parsePrimary()
+	{
+		if (mCond->mError) return;
+		skipSpace();
+
+		char c = *mPos;
+		if (c == '(')
+		{
+			++mPos;
+			parseOr();
+			if (!mCond->mError && !match(")"))
+				fail("Expected ')'");
+		}
+		else if (isdigit((Uint8)c) || ((c == '-' || c == '.') && isdigit((Uint8)mPos[1])))
+			parseNumber();
+		else if (c == '\'' || c == '"')
+			parseName();
+		else if (isIdentStart(c))
+			parseWord();
+		else
+			fail("Expected a value");
+	}
+
+	void parseNumber()
+	{
+		char* end = 0;
+		double val = strtod(mPos, &end);
+
+		// Whole numbers are ints so they compare exactly
+		bool isFloat = false;
+		for (const char* c = mPos; c < end; ++c)
+		{
+			if (*c == '.' || *c == 'e' || *c == 'E')
+				isFloat = true;
+		}
+
+		// Whole numbers outside the int range are kept as doubles
+		if (isFloat)
+			pushConst(Variant((float)val));
+		else if (val >= INT_MIN && val <= INT_MAX)
+			pushConst(Variant((int)val));
+		else
+			pushConst(Variant(val));
+		mPos = end;
+	}
+
+	void parseName()
+	{
+		char quote = *mPos++;
+		const char* start = mPos;
+		while (*mPos && *mPos != quote)
+			++mPos;
+
+		if (!*mPos)
+		{
+			fail("Expected closing quote");
+			return;
+		}
+
+		pushConst(Variant(NameId(std::string(start, mPos))));
+		++mPos;
+	}
+
+	void parseWord()
+	{
+		const char* start = mPos;
+		while (isIdentChar(*mPos))
+			++mPos;
+
+		std::string word(start, mPos);
+		if (word == "true" || word == "false")
+		{
+			pushConst(Variant(word == "true"));
+			return;
+		}
+
+		// Reuse the index of a variable that is already used
+		Uint32 slot = mCond->mStore->add(NameId(word));
+		Uint32 index = 0;
+		while (index < mCond->mSlots.size() && mCond->mSlots[index] != slot)
+			++index;
+		if (index == mCond->mSlots.size())
+			mCond->mSlots.push_back(slot);
+
+		mCond->emit(PushVar, index);
+	}
+
+	void pushConst(const Variant& val)
+	{
+		mCond->mConstants.push_back(val);
+		mCond->emit(PushConst, (Uint32)mCond->mConstants.size() - 1);
+	}
+
+	void skipSpace()
+	{
+		while (isspace((Uint8)*mPos))
+			++mPos;
+	}
+
+	bool match(const char* token)
+	{
+		skipSpace();
+
+		size_t len = strlen(token);
+		if (strncmp(mPos, token, len) != 0)
+			return false;
+
+		mPos += len;
+		return true;
+	}
+
+	bool matchWord(const char* word)
+	{
+		skipSpace();
+
+		size_t len = strlen(word);
+		if (strncmp(mPos, word, len) != 0 || isIdentChar(mPos[len]))
+			return false;
+
+		mPos += len;
+		return true;
+	}
+
+	void fail(const char* error)
+	{
+		if (mCond->mError) return;
+
+		mCond->mError = error;
+		mCond->mErrorPos = (Uint32)(mPos - mExpr);
+	}
+
+private:
+	/* Condition being compiled */
+	Condition* mCond;
+
+	/* Start of the expression */
+	const char* mExpr;
+
+	/* Current parse position */
+	const char* mPos;
+
+	/* Number of unary operands being parsed (nots and parentheses) */
+	Uint32 mNesting;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+Condition::Condition(MemoryResource* resource) :
+	mStore			(0),
+	mCode			(resource),
+	mConstants		(resource),
+	mSlots			(resource),
+	mDepth			(0),
+	mError			(0),
+	mErrorPos		(0)
+{
+
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool Condition::compile(const char* expr, VariableStore* store)
+{
+	clear();
+	mStore = store;
+
+	Parser parser(this, expr);
+	if (parser.parse())
+		return true;
+
+	setFalse();
+	return false;
+}
+
+void Condition::emit(Op op, Uint32 arg)
+{
+	if (mError) return;
+
+	if (op == PushVar || op == PushConst)
+		++mDepth;
+	else if (op != Not)
+		--mDepth;
+
+	if (mDepth > MaxStack)
+	{
+		mError = "Expression is too deep";
+		return;
+	}
+
+	mCode.push_back((Uint32)op | (arg << 8));
+}
+
+void Condition::setFalse()
+{
+	// Keep the error
+	const char* error = mError;
+	Uint32 errorPos = mErrorPos;
+
+	clear();
+	mConstants.push_back(Variant(false));
+	emit(PushConst, 0);
+
+	mError = error;
+	mErrorPos = errorPos;
+}
+
+void Condition::clear()
+{
+	mCode.clear();
+	mConstants.clear();
+	mSlots.clear();
+	mDepth = 0;
+	mError = 0;
+	mErrorPos = 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool Condition::evaluate() const
+{
+	if (mCode.empty()) return true;
+
+	const Variant* stack[MaxStack];
+	Uint32 top = 0;
+	bool ordered = false;
+
+	for (Uint32 i = 0; i < mCode.size(); ++i)
+	{
+		Uint32 arg = mCode[i] >> 8;
+
+		switch (mCode[i] & 0xFF)
+		{
+		case PushVar:
+			stack[top++] = &mStore->get(mSlots[arg]);
+			break;
+
+		case PushConst:
+			stack[top++] = &mConstants[arg];
+			break;
+
+		case Not:
+			stack[top - 1] = toVariant(!isTrue(*stack[top - 1]));
+			break;
+
+		case And:
+			--top;
+			stack[top - 1] = toVariant(isTrue(*stack[top - 1]) && isTrue(*stack[top]));
+			break;
+
+		case Or:
+			--top;
+			stack[top - 1] = toVariant(isTrue(*stack[top - 1]) || isTrue(*stack[top]));
+			break;
+
+		case Equal:
+			--top;
+			stack[top - 1] = toVariant(*stack[top - 1] == *stack[top]);
+			break;
+
+		case NotEqual:
+			--top;
+			stack[top - 1] = toVariant(*stack[top - 1] != *stack[top]);
+			break;
+
+		case Less:
+			--top;
+			stack[top - 1] = toVariant(compare(*stack[top - 1], *stack[top], ordered) < 0 && ordered);
+			break;
+
+		case LessEqual:
+			--top;
+			stack[top - 1] = toVariant(compare(*stack[top - 1], *stack[top], ordered) <= 0 && ordered);
+			break;
+
+		case Greater:
+			--top;
+			stack[top - 1] = toVariant(compare(*stack[top - 1], *stack[top], ordered) > 0 && ordered);
+			break;
+
+		case GreaterEqual:
+			--top;
+			stack[top - 1] = toVariant(compare(*stack[top - 1], *stack[top], ordered) >= 0 && ordered);
+			break;
+		}
+	}
+
+	return isTrue(*stack[0]);
+}
+
+bool Condition::isEmpty() const
+{
+	return mCode.empty();
+}
+
+const char* Condition::getError() const
+{
+	return mError;
+}
+
+Uint32 Condition::getErrorPos() const
+{
+	return mErrorPos;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void Condition::write(std::ostream& stream) const
+{
+	Uint32 size = (Uint32)mCode.size();
+	stream.write((const char*)&size, sizeof(Uint32));
+	if (size)
+		stream.write((const char*)&mCode[0], size * sizeof(Uint32));
+
+	size = (Uint32)mConstants.size();
+	stream.write((const char*)&size, sizeof(Uint32));
+	for (Uint32 i = 0; i < mConstants.size(); ++i)
+		VariableStore::writeValue(stream, mConstants[i]);
+
+	// Slots change between runs, so variables are written by name
+	size = (Uint32)mSlots.size();
+	stream.write((const char*)&size, sizeof(Uint32));
+	for (Uint32 i = 0; i < mSlots.size(); ++i)
+		VariableStore::writeName(stream, mStore->getName(mSlots[i]));
+}
+
+bool Condition::read(std::istream& stream, VariableStore* store)
+{
+	clear();
+	mStore = store;
+
+	if (readCode(stream))
+		return true;
+
+	mError = "Invalid bytecode";
+	setFalse();
+	return false;
+}
+
+bool Condition::readCode(std::istream& stream)
+{
+	Uint32 numCode = 0, numConstants = 0, numSlots = 0;
+
+	if (!stream.read((char*)&numCode, sizeof(Uint32)) || numCode > MaxCode) return false;
+	mCode.resize(numCode);
+	if (numCode && !stream.read((char*)&mCode[0], numCode * sizeof(Uint32))) return false;
+
+	if (!stream.read((char*)&numConstants, sizeof(Uint32))) return false;
+	for (Uint32 i = 0; i < numConstants; ++i)
+	{
+		Variant val;
+		if (!VariableStore::readValue(stream, val)) return false;
+		mConstants.push_back(val);
+	}
+
+	if (!stream.read((char*)&numSlots, sizeof(Uint32))) return false;
+	for (Uint32 i = 0; i < numSlots; ++i)
+	{
+		NameId name;
+		if (!VariableStore::readName(stream, name)) return false;
+		mSlots.push_back(mStore->add(name));
+	}
+
+	// Check the bytecode, so a bad file can't read out of bounds
+	Uint32 depth = 0;
+	for (Uint32 i = 0; i < mCode.size(); ++i)
+	{
+		Uint32 op = mCode[i] & 0xFF;
+		Uint32 arg = mCode[i] >> 8;
+
+		if (op >= NumOps) return false;
+		if (op == PushVar && arg >= mSlots.size()) return false;
+		if (op == PushConst && arg >= mConstants.size()) return false;
+
+		if (op == PushVar || op == PushConst)
+			++depth;
+		else if (op != Not && depth)
+			--depth;
+
+		if (!depth || depth > MaxStack) return false;
+	}
+
+	return depth <= 1;
+}
+
+///////////////////////////////////////////////////////////////////////////////
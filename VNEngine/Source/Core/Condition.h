@@ -0,0 +1,153 @@
+#ifndef CONDITION_H
+#define CONDITION_H
+
+#include <Core/DataTypes.h>
+#include <Core/MemoryResource.h>
+#include <Core/Variant.h>
+#include <Core/VariableStore.h>
+
+#include <istream>
+#include <ostream>
+
+namespace vne
+{
+
+// ============================================================================
+
+/// <summary>
+/// Boolean expression over game variables, compiled to bytecode.
+/// Expressions are made of variable names, numbers, true / false, quoted names ('chapter2'),
+/// comparisons (== != < <= > >=), logic (&& || ! and or not), and parentheses, i.e. "points >= 10 && !met_bob".
+/// Variables are read by slot from a variable store, so evaluating doesn't look up names or allocate.
+/// A variable that was never set is only true when compared equal to another unset variable
+/// </summary>
+class Condition
+{
+public:
+	Condition(MemoryResource* resource = getDefaultResource());
+
+	/// <summary>
+	/// Compile an expression. Variables that don't exist yet are registered in the store
+	/// </summary>
+	/// <param name="expr">Expression</param>
+	/// <param name="store">Store the variables are read from</param>
+	/// <returns>True if the expression compiled, otherwise the condition is always false</returns>
+	bool compile(const char* expr, VariableStore* store);
+
+	/// <summary>
+	/// Evaluate the condition. An empty condition is always true
+	/// </summary>
+	/// <returns>Result</returns>
+	bool evaluate() const;
+
+	/// <summary>
+	/// Returns true if nothing was compiled
+	/// </summary>
+	bool isEmpty() const;
+
+	/// <summary>
+	/// Get the error of the last compile, or null if it succeeded
+	/// </summary>
+	/// <returns>Error message</returns>
+	const char* getError() const;
+
+	/// <summary>
+	/// Get the character position of the last compile error
+	/// </summary>
+	/// <returns>Position in the expression</returns>
+	Uint32 getErrorPos() const;
+
+	/// <summary>
+	/// Write the compiled bytecode. Variables are written by name
+	/// </summary>
+	/// <param name="stream">Output stream</param>
+	void write(std::ostream& stream) const;
+
+	/// <summary>
+	/// Read bytecode written by write()
+	/// </summary>
+	/// <param name="stream">Input stream</param>
+	/// <param name="store">Store the variables are read from</param>
+	/// <returns>True if the condition was read without errors</returns>
+	bool read(std::istream& stream, VariableStore* store);
+
+private:
+	/* Instructions, the low 8 bits are the op code and the rest is the argument */
+	enum Op
+	{
+		PushVar,
+		PushConst,
+		Not,
+		And,
+		Or,
+		Equal,
+		NotEqual,
+		Less,
+		LessEqual,
+		Greater,
+		GreaterEqual,
+		NumOps
+	};
+
+	/* Max number of values on the evaluation stack */
+	static const Uint32 MaxStack = 32;
+
+	/* Max number of instructions read from a stream, longer code is treated as damage */
+	static const Uint32 MaxCode = 65536;
+
+	class Parser;
+
+	/* Add an instruction and track the stack depth */
+	void emit(Op op, Uint32 arg = 0);
+
+	/* Replace the bytecode with a condition that is always false */
+	void setFalse();
+
+	/* Clear bytecode */
+	void clear();
+
+	/* Read bytecode and check that it is valid */
+	bool readCode(std::istream& stream);
+
+private:
+	/// <summary>
+	/// Store variables are read from
+	/// </summary>
+	VariableStore* mStore;
+
+	/// <summary>
+	/// Bytecode
+	/// </summary>
+	ResourceVector<Uint32> mCode;
+
+	/// <summary>
+	/// Constants used by PushConst
+	/// </summary>
+	ResourceVector<Variant> mConstants;
+
+	/// <summary>
+	/// Variable slots used by PushVar
+	/// </summary>
+	ResourceVector<Uint32> mSlots;
+
+	/// <summary>
+	/// Stack depth while compiling
+	/// </summary>
+	Uint32 mDepth;
+
+	/// <summary>
+	/// Last compile error
+	/// </summary>
+	const char* mError;
+
+	/// <summary>
+	/// Position of last compile error
+	/// </summary>
+	Uint32 mErrorPos;
+};
+
+// ============================================================================
+
+}
+
+#endif
@@ -0,0 +1,237 @@
+#include <Core/FrameProfiler.h>
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+
+using namespace vne;
+
+///////////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+/* Ring buffer slot. The sequence number is odd while the frame is being written */
+struct FrameSlot
+{
+	std::atomic<Uint32> mSeq;
+	ProfileFrame mFrame;
+};
+
+FrameSlot gSlots[FrameProfiler::MaxFrames];
+
+/* Number of published frames, the next frame goes in slot gNumFrames % MaxFrames */
+std::atomic<Uint64> gNumFrames(0);
+
+/* Frame being recorded, only touched by the game loop thread */
+ProfileFrame gCurrent;
+bool gInFrame = false;
+
+const char* gZoneNames[] =
+{
+	"SceneSwitch",
+	"Events",
+	"Update",
+	"SceneUpdate",
+	"AnimationUpdate",
+	"UIUpdate",
+	"Render",
+	"UIDraw",
+	"Display"
+};
+
+static_assert(sizeof(gZoneNames) / sizeof(gZoneNames[0]) == (Uint32)ProfileZone::NumZones, "Every zone needs a name");
+
+/* Clock start, set on first use */
+std::chrono::steady_clock::time_point getEpoch()
+{
+	static std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+	return epoch;
+}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+Uint64 ProfileFrame::getZoneTime(ProfileZone zone) const
+{
+	Uint64 time = 0;
+	for (Uint32 i = 0; i < mNumEvents; ++i)
+	{
+		if (mEvents[i].mZone == zone)
+			time += mEvents[i].mDuration;
+	}
+
+	return time;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void FrameProfiler::beginFrame()
+{
+	gCurrent.mIndex = gNumFrames.load(std::memory_order_relaxed);
+	gCurrent.mStart = getTime();
+	gCurrent.mDuration = 0;
+	gCurrent.mNumEvents = 0;
+	gInFrame = true;
+}
+
+void FrameProfiler::endFrame()
+{
+	if (!gInFrame) return;
+
+	gCurrent.mDuration = getTime() - gCurrent.mStart;
+	gInFrame = false;
+
+	Uint64 index = gCurrent.mIndex;
+	FrameSlot& slot = gSlots[index % MaxFrames];
+
+	// Mark the slot as being written before touching the frame
+	Uint32 seq = slot.mSeq.load(std::memory_order_relaxed);
+	slot.mSeq.store(seq + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	// Only copy the events that were used
+	ProfileFrame& frame = slot.mFrame;
+	frame.mIndex = gCurrent.mIndex;
+	frame.mStart = gCurrent.mStart;
+	frame.mDuration = gCurrent.mDuration;
+	frame.mNumEvents = gCurrent.mNumEvents;
+	for (Uint32 i = 0; i < gCurrent.mNumEvents; ++i)
+		frame.mEvents[i] = gCurrent.mEvents[i];
+
+	slot.mSeq.store(seq + 2, std::memory_order_release);
+	gNumFrames.store(index + 1, std::memory_order_release);
+}
+
+void FrameProfiler::record(ProfileZone zone, Uint64 start, Uint64 end)
+{
+	if (!gInFrame || gCurrent.mNumEvents >= ProfileFrame::MaxEvents) return;
+
+	ProfileEvent& e = gCurrent.mEvents[gCurrent.mNumEvents++];
+	e.mZone = zone;
+	e.mStart = start;
+	e.mDuration = end - start;
+}
+
+Uint64 FrameProfiler::getTime()
+{
+	return (Uint64)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - getEpoch()).count();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void FrameProfiler::getFrames(std::vector<ProfileFrame>& frames, Uint32 maxFrames)
+{
+	frames.clear();
+
+	if (maxFrames > MaxFrames)
+		maxFrames = MaxFrames;
+
+	Uint64 end = gNumFrames.load(std::memory_order_acquire);
+	Uint64 begin = end > maxFrames ? end - maxFrames : 0;
+	frames.reserve((size_t)(end - begin));
+
+	ProfileFrame frame;
+	for (Uint64 i = begin; i < end; ++i)
+	{
+		const FrameSlot& slot = gSlots[i % MaxFrames];
+
+		Uint32 seq = slot.mSeq.load(std::memory_order_acquire);
+		if (seq & 1) continue;
+
+		frame.mIndex = slot.mFrame.mIndex;
+		frame.mStart = slot.mFrame.mStart;
+		frame.mDuration = slot.mFrame.mDuration;
+		frame.mNumEvents = slot.mFrame.mNumEvents;
+		if (frame.mNumEvents > ProfileFrame::MaxEvents)
+			frame.mNumEvents = ProfileFrame::MaxEvents;
+		for (Uint32 j = 0; j < frame.mNumEvents; ++j)
+			frame.mEvents[j] = slot.mFrame.mEvents[j];
+
+		// Skip the frame if the writer reused the slot while it was copied
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (slot.mSeq.load(std::memory_order_relaxed) != seq || frame.mIndex != i) continue;
+
+		frames.push_back(frame);
+	}
+}
+
+Uint64 FrameProfiler::getNumFrames()
+{
+	return gNumFrames.load(std::memory_order_acquire);
+}
+
+const char* FrameProfiler::getZoneName(ProfileZone zone)
+{
+	return zone < ProfileZone::NumZones ? gZoneNames[(Uint32)zone] : "";
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool FrameProfiler::writeCsv(const std::string& fname)
+{
+	std::ofstream file(fname);
+	if (!file.is_open()) return false;
+
+	std::vector<ProfileFrame> frames;
+	getFrames(frames);
+
+	// Fixed point, so large start times don't switch to exponent notation
+	file.setf(std::ios::fixed);
+	file.precision(4);
+
+	file << "frame,start_ms,frame_ms";
+	for (Uint32 i = 0; i < (Uint32)ProfileZone::NumZones; ++i)
+		file << ',' << gZoneNames[i] << "_ms";
+	file << '\n';
+
+	for (Uint32 i = 0; i < frames.size(); ++i)
+	{
+		const ProfileFrame& frame = frames[i];
+		file << frame.mIndex << ',' << frame.mStart * 1.0e-6 << ',' << frame.mDuration * 1.0e-6;
+
+		for (Uint32 j = 0; j < (Uint32)ProfileZone::NumZones; ++j)
+			file << ',' << frame.getZoneTime((ProfileZone)j) * 1.0e-6;
+		file << '\n';
+	}
+
+	return true;
+}
+
+bool FrameProfiler::writeTrace(const std::string& fname)
+{
+	std::ofstream file(fname);
+	if (!file.is_open()) return false;
+
+	std::vector<ProfileFrame> frames;
+	getFrames(frames);
+
+	file.setf(std::ios::fixed);
+	file.precision(3);
+
+	// Complete events ("ph":"X") with times in microseconds, nesting is worked out by the viewer
+	file << "{\"traceEvents\":[\n";
+
+	bool first = true;
+	for (Uint32 i = 0; i < frames.size(); ++i)
+	{
+		const ProfileFrame& frame = frames[i];
+
+		file << (first ? "" : ",\n") <<
+			"{\"name\":\"Frame\",\"cat\":\"frame\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":" << frame.mStart / 1000.0 <<
+			",\"dur\":" << frame.mDuration / 1000.0 << ",\"args\":{\"frame\":" << frame.mIndex << "}}";
+		first = false;
+
+		for (Uint32 j = 0; j < frame.mNumEvents; ++j)
+		{
+			const ProfileEvent& e = frame.mEvents[j];
+			file << ",\n{\"name\":\"" << getZoneName(e.mZone) << "\",\"cat\":\"engine\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":" <<
+				e.mStart / 1000.0 << ",\"dur\":" << e.mDuration / 1000.0 << "}";
+		}
+	}
+
+	file << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,234 @@
+#ifndef FRAME_PROFILER_H
+#define FRAME_PROFILER_H
+
+#include <Core/DataTypes.h>
+
+#include <string>
+#include <vector>
+
+/* Frame timers are on in debug builds, define VNE_PROFILER to turn them on in release */
+#if defined(_DEBUG) && !defined(VNE_PROFILER)
+#define VNE_PROFILER
+#endif
+
+#define PROFILE_CONCAT_IMPL(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_IMPL(a, b)
+
+#ifdef VNE_PROFILER
+#define PROFILE_FRAME() vne::ProfileFrameScope PROFILE_CONCAT(_profileFrame, __LINE__)
+#define PROFILE_SCOPE(zone) vne::ProfileScope PROFILE_CONCAT(_profileScope, __LINE__)(vne::ProfileZone::zone)
+#else
+#define PROFILE_FRAME()
+#define PROFILE_SCOPE(zone)
+#endif
+
+namespace vne
+{
+
+// ============================================================================
+
+/// <summary>
+/// Timed phases of a frame
+/// </summary>
+enum class ProfileZone : Uint8
+{
+	SceneSwitch,
+	Events,
+	Update,
+	SceneUpdate,
+	AnimationUpdate,
+	UIUpdate,
+	Render,
+	UIDraw,
+	Display,
+	NumZones
+};
+
+// ============================================================================
+
+/// <summary>
+/// A single timed section of a frame
+/// </summary>
+struct ProfileEvent
+{
+	/// <summary>
+	/// Phase that was timed
+	/// </summary>
+	ProfileZone mZone;
+
+	/// <summary>
+	/// Start time in nanoseconds, relative to when the profiler started
+	/// </summary>
+	Uint64 mStart;
+
+	/// <summary>
+	/// Duration in nanoseconds
+	/// </summary>
+	Uint64 mDuration;
+};
+
+/// <summary>
+/// Timed sections of a single frame
+/// </summary>
+struct ProfileFrame
+{
+	/// <summary>
+	/// Max number of timed sections recorded per frame, the rest are dropped
+	/// </summary>
+	static const Uint32 MaxEvents = 64;
+
+	/// <summary>
+	/// Frame number, counting from the first profiled frame
+	/// </summary>
+	Uint64 mIndex;
+
+	/// <summary>
+	/// Start time in nanoseconds, relative to when the profiler started
+	/// </summary>
+	Uint64 mStart;
+
+	/// <summary>
+	/// Duration of the whole frame in nanoseconds
+	/// </summary>
+	Uint64 mDuration;
+
+	/// <summary>
+	/// Number of recorded sections
+	/// </summary>
+	Uint32 mNumEvents;
+
+	/// <summary>
+	/// Recorded sections, in the order they ended
+	/// </summary>
+	ProfileEvent mEvents[MaxEvents];
+
+	/// <summary>
+	/// Get the total time spent in a phase during this frame
+	/// </summary>
+	/// <param name="zone">Phase</param>
+	/// <returns>Time in nanoseconds</returns>
+	Uint64 getZoneTime(ProfileZone zone) const;
+};
+
+// ============================================================================
+
+/// <summary>
+/// Records the phase timings of the most recent frames in a ring buffer.
+/// Frames are recorded by the game loop thread and published without locks,
+/// so they can be read or exported from any thread while the game runs.
+/// Timers are added with PROFILE_FRAME() and PROFILE_SCOPE(zone), which compile to nothing unless VNE_PROFILER is defined
+/// </summary>
+class FrameProfiler
+{
+public:
+	/// <summary>
+	/// Number of frames kept in the ring buffer
+	/// </summary>
+	static const Uint32 MaxFrames = 256;
+
+public:
+	/// <summary>
+	/// Start recording a frame. Sections timed outside of a frame are dropped
+	/// </summary>
+	static void beginFrame();
+
+	/// <summary>
+	/// Finish the current frame and publish it to the ring buffer
+	/// </summary>
+	static void endFrame();
+
+	/// <summary>
+	/// Add a timed section to the current frame
+	/// </summary>
+	/// <param name="zone">Phase</param>
+	/// <param name="start">Start time from getTime()</param>
+	/// <param name="end">End time from getTime()</param>
+	static void record(ProfileZone zone, Uint64 start, Uint64 end);
+
+	/// <summary>
+	/// Get the current time in nanoseconds, relative to when the profiler started
+	/// </summary>
+	/// <returns>Time in nanoseconds</returns>
+	static Uint64 getTime();
+
+	/// <summary>
+	/// Copy the frames in the ring buffer, oldest first.
+	/// Frames that are overwritten while being copied are skipped
+	/// </summary>
+	/// <param name="frames">Output list of frames</param>
+	/// <param name="maxFrames">Only copy up to this many of the newest frames</param>
+	static void getFrames(std::vector<ProfileFrame>& frames, Uint32 maxFrames = MaxFrames);
+
+	/// <summary>
+	/// Get the number of frames published since the profiler started
+	/// </summary>
+	/// <returns>Number of frames</returns>
+	static Uint64 getNumFrames();
+
+	/// <summary>
+	/// Get the name of a phase
+	/// </summary>
+	/// <param name="zone">Phase</param>
+	/// <returns>Name</returns>
+	static const char* getZoneName(ProfileZone zone);
+
+	/// <summary>
+	/// Write the frames in the ring buffer as CSV, one row per frame with the total time of each phase in milliseconds
+	/// </summary>
+	/// <param name="fname">File path</param>
+	/// <returns>True if the file was written</returns>
+	static bool writeCsv(const std::string& fname);
+
+	/// <summary>
+	/// Write the frames in the ring buffer in the Chrome trace event format, which can be opened in chrome://tracing
+	/// </summary>
+	/// <param name="fname">File path</param>
+	/// <returns>True if the file was written</returns>
+	static bool writeTrace(const std::string& fname);
+};
+
+// ============================================================================
+
+/// <summary>
+/// Records a frame for the lifetime of the object, use PROFILE_FRAME()
+/// </summary>
+class ProfileFrameScope
+{
+public:
+	ProfileFrameScope() { FrameProfiler::beginFrame(); }
+	~ProfileFrameScope() { FrameProfiler::endFrame(); }
+};
+
+/// <summary>
+/// Times a phase for the lifetime of the object, use PROFILE_SCOPE(zone)
+/// </summary>
+class ProfileScope
+{
+public:
+	ProfileScope(ProfileZone zone) :
+		mZone		(zone),
+		mStart		(FrameProfiler::getTime())
+	{ }
+
+	~ProfileScope()
+	{
+		FrameProfiler::record(mZone, mStart, FrameProfiler::getTime());
+	}
+
+private:
+	/// <summary>
+	/// Phase being timed
+	/// </summary>
+	ProfileZone mZone;
+
+	/// <summary>
+	/// Start time
+	/// </summary>
+	Uint64 mStart;
+};
+
+// ============================================================================
+
+}
+
+#endif
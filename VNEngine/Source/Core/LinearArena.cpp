@@ -0,0 +1,148 @@
+#include <Core/LinearArena.h>
+#include <Core/Allocate.h>
+
+using namespace vne;
+
+///////////////////////////////////////////////////////////////////////////////
+
+LinearArena::LinearArena() :
+	mBlock			(0),
+	mCurrent		(0),
+	mEnd			(0),
+	mDtors			(0),
+	mBlockSize		(64 * 1024),
+	mUsedSize		(0)
+{
+
+}
+
+LinearArena::~LinearArena()
+{
+	free();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void* LinearArena::allocate(Uint32 size, Uint32 align)
+{
+	Uint8* ptr = (Uint8*)(((Uint64)mCurrent + align - 1) & ~(Uint64)(align - 1));
+
+	// Get a new block if this one is full
+	if (!mBlock || ptr + size > mEnd)
+	{
+		if (!addBlock(size + align))
+			return 0;
+		ptr = (Uint8*)(((Uint64)mCurrent + align - 1) & ~(Uint64)(align - 1));
+	}
+
+	mCurrent = ptr + size;
+	return ptr;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool LinearArena::addBlock(Uint32 size)
+{
+	// Blocks are always at least the minimum block size
+	size += sizeof(Block);
+	if (size < mBlockSize)
+		size = mBlockSize;
+
+	// Big blocks are backed by huge pages where possible
+	Block* block = (Block*)aligned_alloc(size, 64, AllocLargePages);
+	if (!block) return false;
+
+	// Count the used part of the current block
+	if (mBlock)
+		mUsedSize += (Uint32)(mCurrent - (Uint8*)(mBlock + 1));
+
+	block->mPrev = mBlock;
+	block->mSize = size;
+
+	mBlock = block;
+	mCurrent = (Uint8*)(block + 1);
+	mEnd = (Uint8*)block + size;
+
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void LinearArena::destroyObjects()
+{
+	// Records are in reverse creation order
+	for (DtorRecord* record = mDtors; record; record = record->mNext)
+		record->mDestroy(record->mObject);
+
+	mDtors = 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void LinearArena::reset()
+{
+	destroyObjects();
+
+	if (!mBlock) return;
+
+	// Merge blocks into one that can hold everything
+	if (mBlock->mPrev)
+	{
+		Uint32 size = 0;
+		while (mBlock)
+		{
+			Block* prev = mBlock->mPrev;
+			size += mBlock->mSize;
+
+			aligned_free(mBlock);
+			mBlock = prev;
+		}
+
+		mBlockSize = size;
+		if (!addBlock(0))
+		{
+			mCurrent = 0;
+			mEnd = 0;
+			mUsedSize = 0;
+			return;
+		}
+	}
+
+	// Rewind
+	mCurrent = (Uint8*)(mBlock + 1);
+	mUsedSize = 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void LinearArena::free()
+{
+	destroyObjects();
+
+	while (mBlock)
+	{
+		Block* prev = mBlock->mPrev;
+		aligned_free(mBlock);
+		mBlock = prev;
+	}
+
+	mCurrent = 0;
+	mEnd = 0;
+	mUsedSize = 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void LinearArena::setBlockSize(Uint32 size)
+{
+	mBlockSize = size;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+Uint32 LinearArena::getUsedSize() const
+{
+	return mBlock ? mUsedSize + (Uint32)(mCurrent - (Uint8*)(mBlock + 1)) : 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
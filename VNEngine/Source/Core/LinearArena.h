@@ -0,0 +1,158 @@
+#ifndef LINEAR_ARENA_H
+#define LINEAR_ARENA_H
+
+#include <Core/DataTypes.h>
+
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace vne
+{
+
+// ============================================================================
+
+/// <summary>
+/// Bump pointer allocator for objects that all share the same lifetime.
+/// Objects can't be freed individually, instead all objects are destroyed at once with reset().
+/// Destructors are only recorded for types that aren't trivially destructible
+/// </summary>
+class LinearArena
+{
+public:
+	LinearArena();
+	~LinearArena();
+
+	LinearArena(const LinearArena& other) = delete;
+	LinearArena& operator=(const LinearArena& other) = delete;
+
+	/// <summary>
+	/// Create a new object in the arena. Returns null if the arena couldn't grow
+	/// </summary>
+	template <typename T, typename... Args>
+	T* create(Args&&... args)
+	{
+		// Trivial types don't need to be tracked
+		if (std::is_trivially_destructible<T>::value)
+		{
+			void* mem = allocate(sizeof(T), alignof(T));
+			return mem ? new(mem) T(std::forward<Args>(args)...) : 0;
+		}
+
+		// Destructor record is stored in the arena too
+		DtorRecord* record = (DtorRecord*)allocate(sizeof(DtorRecord), alignof(DtorRecord));
+		void* mem = record ? allocate(sizeof(T), alignof(T)) : 0;
+		if (!mem) return 0;
+
+		T* ptr = new(mem) T(std::forward<Args>(args)...);
+
+		// Only add record once the object has been constructed
+		record->mObject = ptr;
+		record->mDestroy = &destroy<T>;
+		record->mNext = mDtors;
+		mDtors = record;
+
+		return ptr;
+	}
+
+	/// <summary>
+	/// Allocate raw memory from the arena
+	/// </summary>
+	/// <param name="size">Size of memory in bytes</param>
+	/// <param name="align">Alignment of memory, must be a power of two</param>
+	/// <returns>Pointer to memory, or null if a new block couldn't be allocated</returns>
+	void* allocate(Uint32 size, Uint32 align);
+
+	/// <summary>
+	/// Destroy all objects and rewind the arena.
+	/// If more than one block was used, they are replaced with a single block big enough to hold everything
+	/// </summary>
+	void reset();
+
+	/// <summary>
+	/// Destroy all objects and release all memory
+	/// </summary>
+	void free();
+
+	/// <summary>
+	/// Set the size of the first block in bytes. Blocks allocated after the first are at least this big
+	/// </summary>
+	/// <param name="size">Block size in bytes</param>
+	void setBlockSize(Uint32 size);
+
+	/// <summary>
+	/// Get the number of bytes that have been used since the last reset
+	/// </summary>
+	/// <returns>Number of bytes</returns>
+	Uint32 getUsedSize() const;
+
+private:
+	/* Block header (goes at the start of each block) */
+	struct Block
+	{
+		/* Previous block */
+		Block* mPrev;
+		/* Size of block in bytes, including header */
+		Uint32 mSize;
+	};
+
+	/* Records an object that needs to be destroyed */
+	struct DtorRecord
+	{
+		/* Object to destroy */
+		void* mObject;
+		/* Function that calls the destructor */
+		void (*mDestroy)(void*);
+		/* Next record (records are in reverse creation order) */
+		DtorRecord* mNext;
+	};
+
+	template <typename T>
+	static void destroy(void* ptr)
+	{
+		((T*)ptr)->~T();
+	}
+
+	/* Add a new block that can fit an allocation of the given size, returns false if allocation failed */
+	bool addBlock(Uint32 size);
+
+	/* Run all recorded destructors */
+	void destroyObjects();
+
+private:
+	/// <summary>
+	/// Current block
+	/// </summary>
+	Block* mBlock;
+
+	/// <summary>
+	/// Next free byte in the current block
+	/// </summary>
+	Uint8* mCurrent;
+
+	/// <summary>
+	/// End of the current block
+	/// </summary>
+	Uint8* mEnd;
+
+	/// <summary>
+	/// List of objects that need their destructors called
+	/// </summary>
+	DtorRecord* mDtors;
+
+	/// <summary>
+	/// Minimum block size in bytes
+	/// </summary>
+	Uint32 mBlockSize;
+
+	/// <summary>
+	/// Number of bytes used in blocks before the current block
+	/// </summary>
+	Uint32 mUsedSize;
+};
+
+// ============================================================================
+
+}
+
+#endif
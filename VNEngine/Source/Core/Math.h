@@ -1,8 +1,14 @@
 #ifndef MATH_FUNCS_H
 #define MATH_FUNCS_H
 
+#include <Core/DataTypes.h>
+
 #include <SFML/System.hpp>
 
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
 // ============================================================================
 
 namespace vne
@@ -18,6 +24,17 @@ inline float toDegrees(float angle)
 	return angle * 180.0f / 3.141592654f;
 }
 
+inline Uint32 countTrailingZeros(Uint32 x)
+{
+#ifdef _MSC_VER
+	unsigned long index = 0;
+	_BitScanForward(&index, x);
+	return (Uint32)index;
+#else
+	return (Uint32)__builtin_ctz(x);
+#endif
+}
+
 }
 
 // ============================================================================
@@ -0,0 +1,131 @@
+#include <Core/MemoryResource.h>
+#include <Core/Allocate.h>
+#include <Core/LinearArena.h>
+
+using namespace vne;
+
+///////////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+/* Allocates from the global heap */
+class HeapResource : public MemoryResource
+{
+public:
+	void* allocate(size_t size, size_t align) override
+	{
+		return aligned_alloc(size, align, AllocDefault);
+	}
+
+	void deallocate(void* ptr, size_t size, size_t align) override
+	{
+		aligned_free(ptr);
+	}
+};
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+MemoryResource* vne::getDefaultResource()
+{
+	static HeapResource resource;
+	return &resource;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+ArenaResource::ArenaResource(LinearArena* arena) :
+	mArena		(arena)
+{
+
+}
+
+void* ArenaResource::allocate(size_t size, size_t align)
+{
+	return mArena->allocate((Uint32)size, (Uint32)align);
+}
+
+void ArenaResource::deallocate(void* ptr, size_t size, size_t align)
+{
+	// Memory is reclaimed when the arena is reset
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+PoolResource::PoolResource(MemoryResource* upstream) :
+	mUpstream		(upstream)
+{
+	initClass<16>(0);
+	initClass<32>(1);
+	initClass<64>(2);
+	initClass<128>(3);
+	initClass<256>(4);
+	initClass<512>(5);
+	initClass<1024>(6);
+	initClass<2048>(7);
+}
+
+PoolResource::~PoolResource()
+{
+	for (Uint32 i = 0; i < NumClasses; ++i)
+		delete mPools[i];
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+Uint32 PoolResource::getClass(size_t size, size_t align)
+{
+	if (align > 16) return NumClasses;
+
+	Uint32 index = 0;
+	for (size_t blockSize = MinBlockSize; blockSize < size; blockSize <<= 1)
+	{
+		if (++index == NumClasses)
+			break;
+	}
+
+	return index;
+}
+
+void* PoolResource::allocate(size_t size, size_t align)
+{
+	Uint32 index = getClass(size, align);
+	if (index < NumClasses)
+		return mCreate[index](mPools[index]);
+
+	return mUpstream->allocate(size, align);
+}
+
+void PoolResource::deallocate(void* ptr, size_t size, size_t align)
+{
+	Uint32 index = getClass(size, align);
+	if (index < NumClasses)
+		mFree[index](mPools[index], ptr);
+	else
+		mUpstream->deallocate(ptr, size, align);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+ProxyResource::ProxyResource(MemoryResource* target) :
+	mTarget		(target)
+{
+
+}
+
+void* ProxyResource::allocate(size_t size, size_t align)
+{
+	return mTarget->allocate(size, align);
+}
+
+void ProxyResource::deallocate(void* ptr, size_t size, size_t align)
+{
+	mTarget->deallocate(ptr, size, align);
+}
+
+void ProxyResource::setTarget(MemoryResource* target)
+{
+	mTarget = target;
+}
+
+///////////////////////////////////////////////////////////////////////////////
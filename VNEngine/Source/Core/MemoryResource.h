@@ -0,0 +1,248 @@
+#ifndef MEMORY_RESOURCE_H
+#define MEMORY_RESOURCE_H
+
+#include <Core/DataTypes.h>
+#include <Core/ObjectPool.h>
+
+#include <stddef.h>
+#include <new>
+#include <vector>
+
+namespace vne
+{
+
+// ============================================================================
+
+class LinearArena;
+
+/// <summary>
+/// Source of memory for containers (modeled after std::pmr::memory_resource)
+/// </summary>
+class MemoryResource
+{
+public:
+	virtual ~MemoryResource() { }
+
+	/// <summary>
+	/// Allocate memory
+	/// </summary>
+	/// <param name="size">Size in bytes</param>
+	/// <param name="align">Alignment, must be a power of two</param>
+	/// <returns>Pointer to memory, or null if allocation failed</returns>
+	virtual void* allocate(size_t size, size_t align) = 0;
+
+	/// <summary>
+	/// Return memory to the resource. Size and alignment must match the allocation
+	/// </summary>
+	/// <param name="ptr">Pointer to memory</param>
+	/// <param name="size">Size in bytes</param>
+	/// <param name="align">Alignment</param>
+	virtual void deallocate(void* ptr, size_t size, size_t align) = 0;
+};
+
+/// <summary>
+/// Get the resource that allocates from the global heap
+/// </summary>
+/// <returns>Heap resource</returns>
+MemoryResource* getDefaultResource();
+
+// ============================================================================
+
+/// <summary>
+/// Allocates from a linear arena. Deallocation does nothing, memory is reclaimed when the arena is reset
+/// </summary>
+class ArenaResource : public MemoryResource
+{
+public:
+	ArenaResource(LinearArena* arena);
+
+	void* allocate(size_t size, size_t align) override;
+
+	void deallocate(void* ptr, size_t size, size_t align) override;
+
+private:
+	/// <summary>
+	/// Arena to allocate from
+	/// </summary>
+	LinearArena* mArena;
+};
+
+// ============================================================================
+
+/// <summary>
+/// Allocates small blocks from object pools, one pool per power of two size class.
+/// Larger blocks come from the upstream resource. Pool pages are kept until the resource is destroyed,
+/// so a container that is rebuilt the same way every time stops touching the heap after the first time
+/// </summary>
+class PoolResource : public MemoryResource
+{
+public:
+	PoolResource(MemoryResource* upstream = getDefaultResource());
+	~PoolResource();
+
+	PoolResource(const PoolResource& other) = delete;
+	PoolResource& operator=(const PoolResource& other) = delete;
+
+	void* allocate(size_t size, size_t align) override;
+
+	void deallocate(void* ptr, size_t size, size_t align) override;
+
+private:
+	/* Smallest block size */
+	static const Uint32 MinBlockSize = 16;
+	/* Number of size classes (16 bytes to 2 KB) */
+	static const Uint32 NumClasses = 8;
+
+	/* Fixed size block, the constructor leaves the memory uninitialized */
+	template <Uint32 N>
+	struct alignas(16) Block
+	{
+		Block() { }
+
+		Uint8 mData[N];
+	};
+
+	template <Uint32 N>
+	static void* createBlock(IObjectPool* pool)
+	{
+		return ((ObjectPool<Block<N>>*)pool)->create();
+	}
+
+	template <Uint32 N>
+	static void freeBlock(IObjectPool* pool, void* ptr)
+	{
+		((ObjectPool<Block<N>>*)pool)->free((Block<N>*)ptr);
+	}
+
+	/* Create pool for a size class */
+	template <Uint32 N>
+	void initClass(Uint32 index)
+	{
+		// Keep pages around 32 KB for every size class
+		ObjectPool<Block<N>>* pool = new ObjectPool<Block<N>>();
+		pool->setPageSize((32 * 1024 - 512) / N);
+
+		mPools[index] = pool;
+		mCreate[index] = &createBlock<N>;
+		mFree[index] = &freeBlock<N>;
+	}
+
+	/* Get size class index of an allocation, or NumClasses if it is too big to pool */
+	static Uint32 getClass(size_t size, size_t align);
+
+private:
+	/// <summary>
+	/// Used for blocks that are too big or too aligned to pool
+	/// </summary>
+	MemoryResource* mUpstream;
+
+	/// <summary>
+	/// Pools of each size class
+	/// </summary>
+	IObjectPool* mPools[NumClasses];
+
+	/// <summary>
+	/// Create functions of each size class
+	/// </summary>
+	void* (*mCreate[NumClasses])(IObjectPool*);
+
+	/// <summary>
+	/// Free functions of each size class
+	/// </summary>
+	void (*mFree[NumClasses])(IObjectPool*, void*);
+};
+
+// ============================================================================
+
+/// <summary>
+/// Forwards to another resource. The target can only be changed while nothing is allocated
+/// </summary>
+class ProxyResource : public MemoryResource
+{
+public:
+	ProxyResource(MemoryResource* target = getDefaultResource());
+
+	void* allocate(size_t size, size_t align) override;
+
+	void deallocate(void* ptr, size_t size, size_t align) override;
+
+	/// <summary>
+	/// Set the resource that allocations are forwarded to
+	/// </summary>
+	/// <param name="target">Target resource</param>
+	void setTarget(MemoryResource* target);
+
+private:
+	/// <summary>
+	/// Resource that allocations are forwarded to
+	/// </summary>
+	MemoryResource* mTarget;
+};
+
+// ============================================================================
+
+/// <summary>
+/// Standard allocator that draws from a memory resource (like std::pmr::polymorphic_allocator)
+/// </summary>
+template <typename T>
+class ResourceAllocator
+{
+public:
+	typedef T value_type;
+
+	ResourceAllocator(MemoryResource* resource = getDefaultResource()) :
+		mResource(resource)
+	{ }
+
+	template <typename U>
+	ResourceAllocator(const ResourceAllocator<U>& other) :
+		mResource(other.getResource())
+	{ }
+
+	T* allocate(size_t n)
+	{
+		void* ptr = mResource->allocate(n * sizeof(T), alignof(T));
+		if (!ptr)
+			throw std::bad_alloc();
+
+		return (T*)ptr;
+	}
+
+	void deallocate(T* ptr, size_t n)
+	{
+		mResource->deallocate(ptr, n * sizeof(T), alignof(T));
+	}
+
+	MemoryResource* getResource() const
+	{
+		return mResource;
+	}
+
+private:
+	/* Resource to allocate from */
+	MemoryResource* mResource;
+};
+
+template <typename T, typename U>
+bool operator==(const ResourceAllocator<T>& a, const ResourceAllocator<U>& b)
+{
+	return a.getResource() == b.getResource();
+}
+
+template <typename T, typename U>
+bool operator!=(const ResourceAllocator<T>& a, const ResourceAllocator<U>& b)
+{
+	return a.getResource() != b.getResource();
+}
+
+/// <summary>
+/// Vector that allocates from a memory resource
+/// </summary>
+template <typename T>
+using ResourceVector = std::vector<T, ResourceAllocator<T>>;
+
+// ============================================================================
+
+}
+
+#endif
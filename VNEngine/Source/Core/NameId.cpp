@@ -0,0 +1,208 @@
+#include <Core/NameId.h>
+
+#include <deque>
+#include <mutex>
+#include <string.h>
+#include <vector>
+
+using namespace vne;
+
+///////////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+/* Interned string and its hash */
+struct NameEntry
+{
+	sf::String mString;
+	Uint32 mHash;
+};
+
+/* Open addressing hash table of name ids, entries are kept in a deque so string references stay valid */
+struct NameTable
+{
+	NameTable() :
+		mBuckets	(256, 0)
+	{
+		// Id 0 is the empty string, it is never added to the buckets
+		NameEntry empty;
+		empty.mHash = NameId::hash("");
+		mEntries.push_back(empty);
+	}
+
+	std::deque<NameEntry> mEntries;
+	std::vector<Uint32> mBuckets;
+	std::mutex mMutex;
+};
+
+/* Kept in a function so names in static storage can be created safely */
+NameTable& getTable()
+{
+	static NameTable table;
+	return table;
+}
+
+/* Double the number of buckets and reinsert all ids */
+void grow(NameTable& table)
+{
+	std::vector<Uint32> buckets(table.mBuckets.size() * 2, 0);
+	Uint32 mask = (Uint32)buckets.size() - 1;
+
+	for (Uint32 id = 1; id < table.mEntries.size(); ++id)
+	{
+		Uint32 i = table.mEntries[id].mHash & mask;
+		while (buckets[i])
+			i = (i + 1) & mask;
+		buckets[i] = id;
+	}
+
+	table.mBuckets.swap(buckets);
+}
+
+/* Find the id of a string, or add it if it doesn't exist. Returns 0 if the string is new and create() fails */
+template <typename Equal, typename Create>
+Uint32 intern(Uint32 hash, Equal equal, Create create)
+{
+	NameTable& table = getTable();
+	std::lock_guard<std::mutex> lock(table.mMutex);
+
+	Uint32 mask = (Uint32)table.mBuckets.size() - 1;
+	Uint32 i = hash & mask;
+	for (; table.mBuckets[i]; i = (i + 1) & mask)
+	{
+		Uint32 id = table.mBuckets[i];
+		const NameEntry& entry = table.mEntries[id];
+		if (entry.mHash == hash && equal(entry.mString))
+			return id;
+	}
+
+	NameEntry entry;
+	if (!create(entry.mString))
+		return 0;
+	entry.mHash = hash;
+
+	Uint32 id = (Uint32)table.mEntries.size();
+	table.mEntries.push_back(entry);
+	table.mBuckets[i] = id;
+
+	// Keep the load factor under one half
+	if (table.mEntries.size() * 2 > table.mBuckets.size())
+		grow(table);
+
+	return id;
+}
+
+/* Intern a string without converting it first. Returns false if the string is new and not ASCII */
+bool internAscii(const char* name, size_t len, Uint32 hash, Uint32& id)
+{
+	bool isAscii = true;
+
+	id = intern(hash,
+		[&](const sf::String& str)
+		{
+			if (str.getSize() != len) return false;
+			for (size_t i = 0; i < len; ++i)
+			{
+				if (str[i] != (Uint8)name[i])
+					return false;
+			}
+			return true;
+		},
+		[&](sf::String& str)
+		{
+			// Other encodings have to be converted before they are hashed
+			for (size_t i = 0; i < len; ++i)
+			{
+				if ((Uint8)name[i] >= 0x80)
+				{
+					isAscii = false;
+					return false;
+				}
+			}
+
+			str = sf::String(name);
+			return true;
+		});
+
+	return isAscii;
+}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+NameId::NameId(const sf::String& name) :
+	mId			(0)
+{
+	if (name.isEmpty()) return;
+
+	mId = intern(hash(name),
+		[&](const sf::String& str) { return str == name; },
+		[&](sf::String& str) { str = name; return true; });
+}
+
+NameId::NameId(const char* name) :
+	mId			(0)
+{
+	if (!name || !*name) return;
+
+	// Hash and measure in one pass, stop at the first non ASCII character
+	Uint32 h = 2166136261u;
+	size_t len = 0;
+	for (; name[len] && (Uint8)name[len] < 0x80; ++len)
+		h = (h ^ (Uint8)name[len]) * 16777619u;
+
+	if (name[len] || !internAscii(name, len, h, mId))
+		*this = NameId(sf::String(name));
+}
+
+NameId::NameId(const std::string& name) :
+	NameId		(name.c_str())
+{ }
+
+NameId::NameId(const wchar_t* name) :
+	NameId		(sf::String(name))
+{ }
+
+NameId::NameId(const char* name, Uint32 hash) :
+	mId			(0)
+{
+	if (!name || !*name) return;
+
+	if (!internAscii(name, strlen(name), hash, mId))
+		*this = NameId(sf::String(name));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+Uint32 NameId::getHash() const
+{
+	NameTable& table = getTable();
+	std::lock_guard<std::mutex> lock(table.mMutex);
+	return table.mEntries[mId < table.mEntries.size() ? mId : 0].mHash;
+}
+
+const sf::String& NameId::getString() const
+{
+	NameTable& table = getTable();
+	std::lock_guard<std::mutex> lock(table.mMutex);
+	return table.mEntries[mId < table.mEntries.size() ? mId : 0].mString;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+Uint32 NameId::hash(const sf::String& str)
+{
+	Uint32 h = 2166136261u;
+	for (auto it = str.begin(); it != str.end(); ++it)
+		h = (h ^ *it) * 16777619u;
+	return h;
+}
+
+Uint32 NameId::getNumNames()
+{
+	NameTable& table = getTable();
+	std::lock_guard<std::mutex> lock(table.mMutex);
+	return (Uint32)table.mEntries.size();
+}
+
+///////////////////////////////////////////////////////////////////////////////
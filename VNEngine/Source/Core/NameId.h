@@ -0,0 +1,157 @@
+#ifndef NAME_ID_H
+#define NAME_ID_H
+
+#include <Core/DataTypes.h>
+
+#include <functional>
+#include <string>
+#include <type_traits>
+
+/// <summary>
+/// Create a name id from a string literal, with the hash computed at compile time.
+/// Only use this with ASCII literals
+/// </summary>
+#define VNE_NAME(str) vne::NameId(str, std::integral_constant<vne::Uint32, vne::NameId::hash(str)>::value)
+
+namespace vne
+{
+
+// ============================================================================
+
+/// <summary>
+/// 32-bit id of an interned string.
+/// Every distinct string is stored once in a global name table, so names can be compared and hashed as integers.
+/// Ids are only valid for the current run, use getHash() for anything that is saved.
+/// The default id is the empty string
+/// </summary>
+class NameId
+{
+public:
+	NameId() :
+		mId			(0)
+	{ }
+
+	/// <summary>
+	/// Intern a string
+	/// </summary>
+	/// <param name="name">String to intern</param>
+	NameId(const sf::String& name);
+
+	/// <summary>
+	/// Intern a string. ASCII strings are interned without allocating unless they are new
+	/// </summary>
+	/// <param name="name">String to intern</param>
+	NameId(const char* name);
+
+	/// <summary>
+	/// Intern a string
+	/// </summary>
+	/// <param name="name">String to intern</param>
+	NameId(const std::string& name);
+
+	/// <summary>
+	/// Intern a wide string
+	/// </summary>
+	/// <param name="name">String to intern</param>
+	NameId(const wchar_t* name);
+
+	/// <summary>
+	/// Intern an ASCII string with a precomputed hash (see VNE_NAME)
+	/// </summary>
+	/// <param name="name">String to intern</param>
+	/// <param name="hash">Hash of the string, must equal NameId::hash(name)</param>
+	NameId(const char* name, Uint32 hash);
+
+	/// <summary>
+	/// Get a name from an id returned by getId()
+	/// </summary>
+	/// <param name="id">Name id</param>
+	/// <returns>Name id</returns>
+	static NameId fromId(Uint32 id)
+	{
+		NameId name;
+		name.mId = id;
+		return name;
+	}
+
+	/// <summary>
+	/// Get the integer id
+	/// </summary>
+	/// <returns>Id</returns>
+	Uint32 getId() const { return mId; }
+
+	/// <summary>
+	/// Get the string hash, computed once when the string was interned.
+	/// Unlike the id, the hash is the same every run
+	/// </summary>
+	/// <returns>Hash</returns>
+	Uint32 getHash() const;
+
+	/// <summary>
+	/// Get the interned string
+	/// </summary>
+	/// <returns>String</returns>
+	const sf::String& getString() const;
+
+	/// <summary>
+	/// Returns true if the name is the empty string
+	/// </summary>
+	bool isEmpty() const { return mId == 0; }
+
+	bool operator==(NameId other) const { return mId == other.mId; }
+	bool operator!=(NameId other) const { return mId != other.mId; }
+	bool operator<(NameId other) const { return mId < other.mId; }
+
+	/// <summary>
+	/// Hash an ASCII string (32-bit FNV-1a over code points). Can be evaluated at compile time
+	/// </summary>
+	/// <param name="str">String to hash</param>
+	/// <returns>Hash</returns>
+	static constexpr Uint32 hash(const char* str)
+	{
+		Uint32 h = 2166136261u;
+		for (; *str; ++str)
+			h = (h ^ (Uint8)*str) * 16777619u;
+		return h;
+	}
+
+	/// <summary>
+	/// Hash a string, gives the same result as the ASCII version for ASCII strings
+	/// </summary>
+	/// <param name="str">String to hash</param>
+	/// <returns>Hash</returns>
+	static Uint32 hash(const sf::String& str);
+
+	/// <summary>
+	/// Get the number of interned strings
+	/// </summary>
+	/// <returns>Number of names</returns>
+	static Uint32 getNumNames();
+
+private:
+	/// <summary>
+	/// Index into the name table
+	/// </summary>
+	Uint32 mId;
+};
+
+// ============================================================================
+
+}
+
+namespace std
+{
+
+template <>
+struct hash<vne::NameId>
+{
+	size_t operator()(vne::NameId name) const
+	{
+		// Ids are unique and dense, so they don't need to be hashed again
+		return name.getId();
+	}
+};
+
+}
+
+#endif
@@ -3,7 +3,17 @@
 
 #include <Core/DataTypes.h>
 #include <Core/Allocate.h>
+#include <Core/Math.h>
+#include <Core/PoolStats.h>
 
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <new>
+#include <string.h>
+#include <typeinfo>
+#include <utility>
 #include <vector>
 
 namespace vne
@@ -13,17 +23,23 @@ namespace vne
 
 namespace
 {
-/* Page header (actually goes at end of page) */
+/* Page header (goes at the start of each page, followed by the occupancy bitmap) */
 struct PageHeader
 {
 	PageHeader() = default;
-	PageHeader(void* start) :
+	PageHeader(void* pool, void* start) :
+		mPool(pool),
 		mNext(0),
+		mNextPartial(0),
 		mNextFree((void**)start)
 	{ }
 
+	/* Pool that owns this page */
+	void* mPool;
 	/* Pointer to next page */
 	void* mNext;
+	/* Pointer to next page with free slots (only valid while this page has free slots) */
+	void* mNextPartial;
 	/* Free list */
 	void** mNextFree;
 };
@@ -39,25 +55,41 @@ public:
 	virtual ~IObjectPool() { }
 
 	virtual void free() = 0;
+
+	virtual void reset() = 0;
+
+	virtual void setMaxCachedPages(Uint32 pages) = 0;
+
+	virtual void reserve(Uint32 numObjects) = 0;
+
+	virtual const char* getTypeName() const = 0;
+
+	virtual const PoolStats& getStats() const = 0;
 };
 
 /* Paged pool allocator */
 template <typename T>
 class ObjectPool : public IObjectPool
 {
+	static_assert(sizeof(T) >= sizeof(void*), "ObjectPool objects must be able to hold a free list pointer");
+
 public:
 	ObjectPool() :
 		mStart(0),
-		mCurrent(0),
-		mLast(0),
-		mPageSize(128)
+		mPartial(0),
+		mPageSize(128),
+		mPageBytes(0),
+		mSlotOffset(0),
+		mMaxCachedPages(0xFFFFFFFF),
+		mNumPages(0)
 	{
-
+		POOL_STAT(initStats());
 	}
 
 	~ObjectPool()
 	{
 		free();
+		POOL_STAT(PoolStatsRegistry::remove(&mStats));
 	}
 
 	ObjectPool(const ObjectPool& other) = delete;
@@ -65,17 +97,29 @@ public:
 
 	ObjectPool(ObjectPool&& other) :
 		mStart(0),
-		mCurrent(0)
+		mPartial(0)
 	{
 		mStart = other.mStart;
-		mCurrent = other.mCurrent;
-		mLast = other.mLast;
+		mPartial = other.mPartial;
 		mPageSize = other.mPageSize;
+		mPageBytes = other.mPageBytes;
+		mSlotOffset = other.mSlotOffset;
+		mMaxCachedPages = other.mMaxCachedPages;
+		mNumPages = other.mNumPages;
+
+		// Pages keep a pointer to their owner
+		for (Uint8* page = mStart; page; page = (Uint8*)getHeader(page)->mNext)
+			getHeader(page)->mPool = this;
+
+		POOL_STAT(initStats());
+		POOL_STAT(moveStats(other));
 
 		other.mStart = 0;
-		other.mCurrent = 0;
-		other.mLast = 0;
+		other.mPartial = 0;
 		other.mPageSize = 1024;
+		other.mPageBytes = 0;
+		other.mSlotOffset = 0;
+		other.mNumPages = 0;
 	}
 
 	ObjectPool& operator=(ObjectPool&& other)
@@ -86,144 +130,308 @@ public:
 				free();
 
 			mStart = other.mStart;
-			mCurrent = other.mCurrent;
-			mLast = other.mLast;
+			mPartial = other.mPartial;
 			mPageSize = other.mPageSize;
+			mPageBytes = other.mPageBytes;
+			mSlotOffset = other.mSlotOffset;
+			mMaxCachedPages = other.mMaxCachedPages;
+			mNumPages = other.mNumPages;
+
+			// Pages keep a pointer to their owner
+			for (Uint8* page = mStart; page; page = (Uint8*)getHeader(page)->mNext)
+				getHeader(page)->mPool = this;
+
+			POOL_STAT(moveStats(other));
 
 			other.mStart = 0;
-			other.mCurrent = 0;
-			other.mLast = 0;
+			other.mPartial = 0;
 			other.mPageSize = 1024;
+			other.mPageBytes = 0;
+			other.mSlotOffset = 0;
+			other.mNumPages = 0;
 		}
 
 		return *this;
 	}
 
 	/* Free (all) memory */
-	void free()
+	void free() override
 	{
-		std::vector<bool> filled(mPageSize, true);
-
-		T* ptr = mStart;
-		while (ptr)
+		Uint8* page = mStart;
+		while (page)
 		{
-			T* page = ptr;
-			PageHeader* header = (PageHeader*)(page + mPageSize);
-			ptr = (T*)header->mNext;
+			Uint8* next = (Uint8*)getHeader(page)->mNext;
 
-			// Mark which slots were not used
-			T** nextFree = (T**)header->mNextFree;
-			while (nextFree)
-			{
-				filled[(T*)nextFree - page] = false;
-				nextFree = (T**)(*nextFree);
-			}
+			destroyObjects(page);
+			page_free(page);
 
-			// Call destructors on ones that are being used
-			for (Uint32 i = 0; i < mPageSize; ++i)
-			{
-				if (filled[i])
-					(page + i)->~T();
-				else
-					filled[i] = true;
-			}
-
-			aligned_free(page);
+			page = next;
 		}
 
 		mStart = 0;
-		mCurrent = 0;
-		mLast = 0;
+		mPartial = 0;
+		mNumPages = 0;
+
+		POOL_STAT(mStats.mNumLive = 0);
+		POOL_STAT(mStats.mPeakLive = 0);
+		POOL_STAT(mStats.mNumPages = 0);
+		POOL_STAT(mStats.mBytesReserved = 0);
 	}
 
-	/* Create new object */
-	template <typename... Args>
-	T* create(Args&&... args)
+	/* Destroy all objects, but keep up to the max number of cached pages for reuse */
+	void reset() override
 	{
-		if (!mStart || !mCurrent)
-		{
-			mStart = allocPage(mPageSize);
-			mCurrent = mStart;
-			mLast = mCurrent;
-		}
+		Uint8* page = mStart;
+		Uint32 numKept = 0;
 
-		// Get header of current page
-		PageHeader* header = (PageHeader*)(mCurrent + mPageSize);
+		mStart = 0;
+		mPartial = 0;
 
-		// If this page is filled up...
-		if (!header->mNextFree)
+		while (page)
 		{
-			// Find first page with free slots
-			T* page = mStart;
-			// While current page exists...
-			while (page)
-			{
-				header = (PageHeader*)(page + mPageSize);
-				// If this page has open slots, break loop
-				if (header->mNextFree) break;
+			Uint8* next = (Uint8*)getHeader(page)->mNext;
 
-				// Go to next page
-				page = (T*)header->mNext;
-			}
+			destroyObjects(page);
 
-			// If a page with empty slots was found...
-			if (page)
+			if (numKept < mMaxCachedPages)
 			{
-				// Make this page the current
-				mCurrent = page;
-			}
+				// Reset free list and put the page back into both lists
+				initPage(page);
+				getHeader(page)->mNext = mStart;
+				getHeader(page)->mNextPartial = mPartial;
+				mStart = page;
+				mPartial = page;
 
-			// Otherwise...
-			else
-			{
-				// Allocate new block
-				mCurrent = allocPage(mPageSize);
-				// Make header of the last page point to new page
-				header = (PageHeader*)(mLast + mPageSize);
-				header->mNext = mCurrent;
-
-				// Update header
-				header = (PageHeader*)(mCurrent + mPageSize);
-				// Update last page
-				mLast = mCurrent;
+				++numKept;
 			}
+			else
+				page_free(page);
+
+			page = next;
 		}
 
+		mNumPages = numKept;
+
+		POOL_STAT(mStats.mNumLive = 0);
+		POOL_STAT(mStats.mPeakLive = 0);
+		POOL_STAT(mStats.mNumPages = numKept);
+		POOL_STAT(mStats.mBytesReserved = (Uint64)numKept * mPageBytes);
+	}
+
+	/* Create new object, returns null if a new page couldn't be allocated */
+	template <typename... Args>
+	T* create(Args&&... args)
+	{
+		// If every page is full, allocate a new one
+		if (!mPartial)
+		{
+			Uint8* page = allocPage();
+			if (!page) return 0;
+
+			// Add to list of all pages
+			getHeader(page)->mNext = mStart;
+			mStart = page;
+
+			// Add to list of pages with free slots
+			mPartial = page;
+		}
+
+		// Use the first page that has free slots
+		PageHeader* header = getHeader(mPartial);
+
 		// Next free stores pointer to slot location
 		T* ptr = (T*)header->mNextFree;
 
+		// Mark slot as used
+		Uint32 index = (Uint32)(ptr - getSlots(mPartial));
+		getBitmap(mPartial)[index >> 5] |= 1u << (index & 31);
+
 		// Update next free
 		header->mNextFree = (void**)(*header->mNextFree);
 
+		// Remove page from the partial list once it is full
+		if (!header->mNextFree)
+		{
+			mPartial = (Uint8*)header->mNextPartial;
+			header->mNextPartial = 0;
+		}
+
 		// Initialize object
 		new(ptr)T(std::forward<Args>(args)...);
 
+		POOL_STAT(++mStats.mNumCreates);
+		POOL_STAT(if (++mStats.mNumLive > mStats.mPeakLive) mStats.mPeakLive = mStats.mNumLive);
+
 		return ptr;
 	}
 
 	/* Free object */
 	void free(T* ptr)
 	{
-		// Find which page pointer belongs to
-		T* page = mStart;
-		while (page)
-		{
-			// If pointer is inside block, then break from loop
-			if (ptr >= page && ptr < page + mPageSize) break;
+		if (!ptr || !mStart) return;
 
-			// Go to next page
-			page = (T*)((PageHeader*)(page + mPageSize))->mNext;
-		}
+		// Pages are aligned to their size, so the page header is found by masking the pointer
+		PageHeader* header = (PageHeader*)((Uint64)ptr & ~(Uint64)(mPageBytes - 1));
+
+		// Make sure the pointer belongs to this pool
+		if (header->mPool != this) return;
 
-		if (!page) return;
+		// Make sure the object hasn't already been freed
+		Uint8* page = (Uint8*)header;
+		Uint32 index = (Uint32)(ptr - getSlots(page));
+		Uint32& word = getBitmap(page)[index >> 5];
+		if (!(word & (1u << (index & 31)))) return;
+
+		// Mark slot as free
+		word &= ~(1u << (index & 31));
 
 		// Call destructor
 		ptr->~T();
 
+		// A full page gets a free slot, so add it back to the partial list
+		if (!header->mNextFree)
+		{
+			header->mNextPartial = mPartial;
+			mPartial = page;
+		}
+
 		// Update free list
-		PageHeader* header = (PageHeader*)(page + mPageSize);
 		*(void**)ptr = (void*)header->mNextFree;
 		header->mNextFree = (void**)ptr;
+
+		POOL_STAT(++mStats.mNumFrees);
+		POOL_STAT(--mStats.mNumLive);
+	}
+
+	/* Call a function on every live object. Pages are visited newest first, objects within a page in slot order */
+	template <typename F>
+	void forEach(F func)
+	{
+		for (Uint8* page = mStart; page; page = (Uint8*)getHeader(page)->mNext)
+		{
+			Uint32* bitmap = getBitmap(page);
+			T* slots = getSlots(page);
+
+			for (Uint32 i = 0, numWords = getNumWords(); i < numWords; ++i)
+			{
+				// Visit each set bit
+				for (Uint32 word = bitmap[i]; word; word &= word - 1)
+					func(slots + (i << 5) + countTrailingZeros(word));
+			}
+		}
+	}
+
+	/* Iterates live objects in the same order as forEach */
+	class Iterator
+	{
+	public:
+		Iterator(const ObjectPool* pool, Uint8* page) :
+			mPool(pool),
+			mPage(page),
+			mIndex(0)
+		{
+			// Move to the first live object
+			if (mPage && !mPool->isUsed(mPage, 0))
+				next();
+		}
+
+		T& operator*() const { return mPool->getSlots(mPage)[mIndex]; }
+		T* operator->() const { return mPool->getSlots(mPage) + mIndex; }
+
+		Iterator& operator++()
+		{
+			next();
+			return *this;
+		}
+
+		bool operator==(const Iterator& other) const { return mPage == other.mPage && mIndex == other.mIndex; }
+		bool operator!=(const Iterator& other) const { return !(*this == other); }
+
+	private:
+		/* Move to the next live object */
+		void next()
+		{
+			while (mPage)
+			{
+				Uint32* bitmap = mPool->getBitmap(mPage);
+
+				// Find next set bit in this page
+				for (Uint32 i = mIndex + 1; i < mPool->mPageSize; )
+				{
+					Uint32 word = bitmap[i >> 5] & (0xFFFFFFFFu << (i & 31));
+					if (word)
+					{
+						mIndex = (i & ~31u) + countTrailingZeros(word);
+						return;
+					}
+
+					i = (i & ~31u) + 32;
+				}
+
+				// Go to the start of the next page
+				mPage = (Uint8*)mPool->getHeader(mPage)->mNext;
+				mIndex = 0;
+
+				if (mPage && mPool->isUsed(mPage, 0))
+					return;
+			}
+
+			mIndex = 0;
+		}
+
+	private:
+		/* Pool being iterated */
+		const ObjectPool* mPool;
+		/* Current page */
+		Uint8* mPage;
+		/* Slot index in current page */
+		Uint32 mIndex;
+	};
+
+	/* Get iterator to first live object */
+	Iterator begin() const
+	{
+		return Iterator(this, mStart);
+	}
+
+	/* Get end iterator */
+	Iterator end() const
+	{
+		return Iterator(this, 0);
+	}
+
+	/* Allocate enough pages up front so the pool can hold the given number of objects in total */
+	void reserve(Uint32 numObjects) override
+	{
+		// Before the first page, grow the page size so the objects fit in fewer, larger pages
+		if (!mPageBytes && numObjects > mPageSize)
+		{
+			Uint32 pageSize = numObjects < MaxReservePageBytes / (Uint32)sizeof(T) ? numObjects : MaxReservePageBytes / (Uint32)sizeof(T);
+			while (pageSize > mPageSize && getSlotOffset(pageSize) + pageSize * (Uint32)sizeof(T) > MaxReservePageBytes)
+				--pageSize;
+
+			if (pageSize > mPageSize)
+				mPageSize = pageSize;
+		}
+
+		initLayout();
+
+		while ((Uint64)mNumPages * mPageSize < numObjects)
+		{
+			Uint8* page = allocPage();
+			if (!page) return;
+
+			getHeader(page)->mNext = mStart;
+			getHeader(page)->mNextPartial = mPartial;
+			mStart = page;
+			mPartial = page;
+		}
+	}
+
+	/* Get the name of the pooled type */
+	const char* getTypeName() const override
+	{
+		return typeid(T).name();
 	}
 
 	/* Set page size if nothing has been allocated yet */
@@ -232,32 +440,597 @@ public:
 		mPageSize = size;
 	}
 
+	/* Set the max number of pages that are kept on reset */
+	void setMaxCachedPages(Uint32 pages) override
+	{
+		mMaxCachedPages = pages;
+	}
+
+	/* Set the name used in pool stats (only stored when pool counters are on) */
+	void setName(const char* name)
+	{
+		POOL_STAT(mStats.mName = name);
+	}
+
+	/* Get usage counters */
+	const PoolStats& getStats() const override
+	{
+		return mStats;
+	}
+
 private:
-	/* Allocate page */
-	T* allocPage(Uint32 size)
+	/* Get the header of a page */
+	PageHeader* getHeader(Uint8* page) const
 	{
-		T* ptr = (T*)aligned_alloc(size * sizeof(T) + sizeof(PageHeader), alignof(T));
+		return (PageHeader*)page;
+	}
+
+	/* Get the first object slot of a page */
+	T* getSlots(Uint8* page) const
+	{
+		return (T*)(page + mSlotOffset);
+	}
 
-		// Initialize free list
-		T* end = ptr + size;
+	/* Get the occupancy bitmap of a page */
+	Uint32* getBitmap(Uint8* page) const
+	{
+		return (Uint32*)(page + sizeof(PageHeader));
+	}
+
+	/* Get the number of words in the occupancy bitmap */
+	Uint32 getNumWords() const
+	{
+		return (mPageSize + 31) >> 5;
+	}
+
+	/* Returns true if a slot holds a live object */
+	bool isUsed(Uint8* page, Uint32 index) const
+	{
+		return (getBitmap(page)[index >> 5] >> (index & 31)) & 1;
+	}
+
+	/* Call destructors of all objects in a page */
+	void destroyObjects(Uint8* page)
+	{
+		Uint32* bitmap = getBitmap(page);
+		T* slots = getSlots(page);
+
+		for (Uint32 i = 0, numWords = getNumWords(); i < numWords; ++i)
+		{
+			for (Uint32 word = bitmap[i]; word; word &= word - 1)
+				(slots + (i << 5) + countTrailingZeros(word))->~T();
+		}
+	}
+
+	/* Initialize free list and header of a page */
+	void initPage(Uint8* page)
+	{
+		T* ptr = getSlots(page);
+		T* end = ptr + mPageSize;
 		for (T* start = ptr; start < end; ++start)
 			*(void**)start = start + 1;
-		*(void**)(ptr + size - 1) = 0;
+		*(void**)(ptr + mPageSize - 1) = 0;
+
+		*getHeader(page) = PageHeader(this, ptr);
+
+		// All slots start free
+		memset(getBitmap(page), 0, getNumWords() * sizeof(Uint32));
+	}
+
+	/* Get offset of the first object for a page with the given number of slots */
+	static Uint32 getSlotOffset(Uint32 numSlots)
+	{
+		// Free list pointers are stored in the slots, so keep the first slot pointer aligned too
+		const Uint32 align = alignof(T) > alignof(void*) ? (Uint32)alignof(T) : (Uint32)alignof(void*);
+
+		Uint32 offset = (Uint32)sizeof(PageHeader) + ((numSlots + 31) >> 5) * (Uint32)sizeof(Uint32);
+		return (offset + align - 1) & ~(align - 1);
+	}
+
+	/* Calculate page layout the first time a page is needed */
+	void initLayout()
+	{
+		if (!mPageBytes)
+		{
+			// Round the page up to a power of two so it can be used as the page alignment
+			Uint32 size = getSlotOffset(mPageSize) + mPageSize * (Uint32)sizeof(T);
+			mPageBytes = 1;
+			while (mPageBytes < size)
+				mPageBytes <<= 1;
+
+			// Use up any extra space that was added by rounding
+			mPageSize = (mPageBytes - getSlotOffset(mPageSize)) / (Uint32)sizeof(T);
+			while (getSlotOffset(mPageSize) + mPageSize * (Uint32)sizeof(T) > mPageBytes)
+				--mPageSize;
+
+			// Objects start after the header and bitmap
+			mSlotOffset = getSlotOffset(mPageSize);
+		}
+	}
+
+	/* Allocate page */
+	Uint8* allocPage()
+	{
+		initLayout();
+
+		Uint8* page = (Uint8*)page_alloc(mPageBytes, mPageBytes);
+		if (!page) return 0;
+
+		initPage(page);
+		++mNumPages;
+
+		POOL_STAT(mStats.mPageSize = mPageSize);
+		POOL_STAT(++mStats.mNumPages);
+		POOL_STAT(++mStats.mNumPageAllocs);
+		POOL_STAT(mStats.mBytesReserved += mPageBytes);
+
+		return page;
+	}
+
+	/* Register stats */
+	void initStats()
+	{
+		mStats.mName = typeid(T).name();
+		mStats.mObjectSize = (Uint32)sizeof(T);
+		PoolStatsRegistry::add(&mStats);
+	}
+
+	/* Take counters from another pool */
+	void moveStats(ObjectPool& other)
+	{
+		mStats.mName = other.mStats.mName;
+		mStats.mPageSize = other.mStats.mPageSize;
+		mStats.mNumLive = other.mStats.mNumLive;
+		mStats.mPeakLive = other.mStats.mPeakLive;
+		mStats.mNumPages = other.mStats.mNumPages;
+		mStats.mBytesReserved = other.mStats.mBytesReserved;
+		mStats.mNumCreates = other.mStats.mNumCreates;
+		mStats.mNumFrees = other.mStats.mNumFrees;
+		mStats.mNumPageAllocs = other.mStats.mNumPageAllocs;
+
+		other.mStats.mNumLive = 0;
+		other.mStats.mNumPages = 0;
+		other.mStats.mBytesReserved = 0;
+	}
+
+private:
+	/* Largest page reserve() picks when it grows the page size */
+	static const Uint32 MaxReservePageBytes = 64 * 1024;
+
+	/* Ptr to first page */
+	Uint8* mStart;
+	/* First page with free slots */
+	Uint8* mPartial;
+	/* Page size (number of objects per page) */
+	Uint32 mPageSize;
+	/* Page size in bytes, which is also the page alignment */
+	Uint32 mPageBytes;
+	/* Offset of the first object from the start of a page */
+	Uint32 mSlotOffset;
+	/* Max number of pages kept on reset */
+	Uint32 mMaxCachedPages;
+	/* Number of allocated pages */
+	Uint32 mNumPages;
+
+	/* Usage counters */
+	PoolStats mStats;
+};
 
-		*(PageHeader*)(ptr + size) = PageHeader(ptr);
+// ============================================================================
+
+/* Pool with per thread caches, told when a thread exits so the thread's cache can go back to the pool */
+class IThreadCachePool
+{
+public:
+	virtual ~IThreadCachePool() { }
+
+	/* Give the cache of a thread index back to the pool. Called on the exiting thread */
+	virtual void releaseCache(Uint32 index) = 0;
+};
+
+/* Hands out small thread indices, and takes them back when threads exit */
+class PoolThreadRegistry
+{
+public:
+	/* Get the registry, kept in a function so it outlives every thread index */
+	static PoolThreadRegistry& get()
+	{
+		static PoolThreadRegistry registry;
+		return registry;
+	}
+
+	/* Get the smallest unused index */
+	Uint32 acquire()
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		if (mFreeIndices.empty())
+			return mNumIndices++;
+
+		// Free indices are kept sorted high to low, so the lowest is reused first
+		Uint32 index = mFreeIndices.back();
+		mFreeIndices.pop_back();
+		return index;
+	}
+
+	/* Return the caches of an exiting thread to every pool, then free its index */
+	void release(Uint32 index)
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		for (Uint32 i = 0; i < mPools.size(); ++i)
+			mPools[i]->releaseCache(index);
+
+		mFreeIndices.insert(std::upper_bound(mFreeIndices.begin(), mFreeIndices.end(), index, std::greater<Uint32>()), index);
+	}
+
+	/* Start telling a pool about exiting threads */
+	void add(IThreadCachePool* pool)
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mPools.push_back(pool);
+	}
+
+	/* Stop telling a pool about exiting threads */
+	void remove(IThreadCachePool* pool)
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mPools.erase(std::remove(mPools.begin(), mPools.end(), pool), mPools.end());
+	}
+
+private:
+	PoolThreadRegistry() :
+		mNumIndices(0)
+	{ }
+
+	/* Number of indices handed out so far */
+	Uint32 mNumIndices;
+	/* Indices of threads that exited */
+	std::vector<Uint32> mFreeIndices;
+	/* Pools with thread caches */
+	std::vector<IThreadCachePool*> mPools;
+	/* Protects the registry */
+	std::mutex mMutex;
+};
+
+/* Thread index that is given back when the thread exits */
+struct PoolThreadIndex
+{
+	PoolThreadIndex() :
+		mIndex(PoolThreadRegistry::get().acquire())
+	{ }
+
+	~PoolThreadIndex()
+	{
+		PoolThreadRegistry::get().release(mIndex);
+	}
+
+	Uint32 mIndex;
+};
+
+/* Get a small unique index for the calling thread, used to find its pool caches.
+   Indices of threads that exited are reused */
+inline Uint32 getPoolThreadIndex()
+{
+	static thread_local PoolThreadIndex sIndex;
+	return sIndex.mIndex;
+}
+
+/* Thread safe paged pool allocator.
+   Each thread keeps a cache of free slots, so create/free only lock the shared depot
+   when the cache runs empty or full. A thread that exits gives its cache back to the depot.
+   Pages are added to a lock free list */
+template <typename T>
+class ConcurrentObjectPool : public IThreadCachePool
+{
+public:
+	ConcurrentObjectPool() :
+		mPages(0),
+		mPageSize(128)
+	{
+		for (Uint32 i = 0; i < MaxThreads; ++i)
+			mCaches[i] = 0;
+
+		PoolThreadRegistry::get().add(this);
+	}
+
+	~ConcurrentObjectPool()
+	{
+		PoolThreadRegistry::get().remove(this);
+		free();
+	}
+
+	ConcurrentObjectPool(const ConcurrentObjectPool& other) = delete;
+	ConcurrentObjectPool& operator=(const ConcurrentObjectPool& other) = delete;
+
+	/* Free (all) memory. No other thread can be using the pool while this runs */
+	void free()
+	{
+		destroyObjects();
+
+		Page* page = mPages.exchange(0);
+		while (page)
+		{
+			Page* next = page->mNext;
+			aligned_free(page);
+			page = next;
+		}
+
+		// Threads that exit meanwhile hand their caches back under the same lock
+		std::lock_guard<std::mutex> lock(mDepotMutex);
+		for (Uint32 i = 0; i < MaxThreads; ++i)
+		{
+			delete mCaches[i];
+			mCaches[i] = 0;
+		}
+
+		mDepot.clear();
+	}
+
+	/* Destroy all objects, but keep all pages for reuse. No other thread can be using the pool while this runs */
+	void reset()
+	{
+		destroyObjects();
+
+		std::lock_guard<std::mutex> lock(mDepotMutex);
+		for (Uint32 i = 0; i < MaxThreads; ++i)
+		{
+			if (mCaches[i])
+				mCaches[i]->mCount = 0;
+		}
+
+		// Every slot goes back into the depot
+		mDepot.clear();
+		for (Page* page = mPages.load(); page; page = page->mNext)
+		{
+			T* slots = getSlots(page);
+			for (Uint32 i = 0; i < mPageSize; ++i)
+				mDepot.push_back(slots + i);
+		}
+	}
+
+	/* Create new object, returns null if a new page couldn't be allocated */
+	template <typename... Args>
+	T* create(Args&&... args)
+	{
+		Cache* cache = getCache();
+		T* ptr = 0;
+
+		if (cache)
+		{
+			// Refill from the depot or a new page when the cache is empty
+			if (!cache->mCount && !refill(cache))
+				return 0;
+
+			ptr = cache->mSlots[--cache->mCount];
+		}
+		else if (!(ptr = takeSlot()))
+			return 0;
+
+		// Initialize object
+		new(ptr)T(std::forward<Args>(args)...);
 
 		return ptr;
 	}
 
+	/* Free object, it can be freed from any thread */
+	void free(T* ptr)
+	{
+		if (!ptr) return;
+
+		// Call destructor
+		ptr->~T();
+
+		Cache* cache = getCache();
+		if (!cache)
+		{
+			std::lock_guard<std::mutex> lock(mDepotMutex);
+			mDepot.push_back(ptr);
+			return;
+		}
+
+		// Move half of a full cache to the depot so other threads can use it
+		if (cache->mCount == CacheSize)
+			flush(cache);
+
+		cache->mSlots[cache->mCount++] = ptr;
+	}
+
+	/* Move the cache of an exiting thread to the depot, the next thread with the index starts with an empty cache */
+	void releaseCache(Uint32 index) override
+	{
+		if (index >= MaxThreads) return;
+
+		std::lock_guard<std::mutex> lock(mDepotMutex);
+		Cache* cache = mCaches[index];
+		if (!cache) return;
+
+		mDepot.insert(mDepot.end(), cache->mSlots, cache->mSlots + cache->mCount);
+		cache->mCount = 0;
+	}
+
+	/* Set page size if nothing has been allocated yet */
+	void setPageSize(Uint32 size)
+	{
+		mPageSize = size;
+	}
+
+private:
+	/* Max number of threads that get their own cache, any other threads use the depot directly */
+	static const Uint32 MaxThreads = 64;
+	/* Number of slots moved between a cache and the depot at once */
+	static const Uint32 BatchSize = 32;
+	/* Max number of slots in a cache */
+	static const Uint32 CacheSize = BatchSize * 2;
+
+	/* Page header (goes at the start of each page) */
+	struct Page
+	{
+		/* Pointer to next page */
+		Page* mNext;
+	};
+
+	/* Per thread cache of free slots */
+	struct Cache
+	{
+		Cache() : mCount(0) { }
+
+		/* Number of free slots */
+		Uint32 mCount;
+		/* Free slots */
+		T* mSlots[CacheSize];
+		/* Keep caches of different threads off the same cache line */
+		Uint8 mPadding[64];
+	};
+
+private:
+	/* Get the first object slot of a page */
+	T* getSlots(Page* page) const
+	{
+		return (T*)((Uint8*)page + getSlotOffset());
+	}
+
+	/* Get offset of the first object from the start of a page */
+	static Uint32 getSlotOffset()
+	{
+		return (Uint32)((sizeof(Page) + alignof(T) - 1) & ~(alignof(T) - 1));
+	}
+
+	/* Get the calling thread's cache, or null if the thread doesn't have one */
+	Cache* getCache()
+	{
+		Uint32 index = getPoolThreadIndex();
+		if (index >= MaxThreads) return 0;
+
+		// Only the owning thread creates its cache
+		Cache*& cache = mCaches[index];
+		if (!cache)
+			cache = new Cache();
+
+		return cache;
+	}
+
+	/* Fill an empty cache, returns false if a new page couldn't be allocated */
+	bool refill(Cache* cache)
+	{
+		{
+			std::lock_guard<std::mutex> lock(mDepotMutex);
+
+			Uint32 count = mDepot.size() < BatchSize ? (Uint32)mDepot.size() : (Uint32)BatchSize;
+			if (count)
+			{
+				memcpy(cache->mSlots, &mDepot[mDepot.size() - count], count * sizeof(T*));
+				mDepot.resize(mDepot.size() - count);
+				cache->mCount = count;
+				return true;
+			}
+		}
+
+		// Depot is empty, so allocate a new page outside of the lock
+		T* slots = allocPage();
+		if (!slots) return false;
+
+		// Keep a batch for this thread and give the rest to the depot
+		Uint32 count = mPageSize < BatchSize ? mPageSize : (Uint32)BatchSize;
+		for (Uint32 i = 0; i < count; ++i)
+			cache->mSlots[i] = slots + mPageSize - 1 - i;
+		cache->mCount = count;
+
+		if (count < mPageSize)
+		{
+			std::lock_guard<std::mutex> lock(mDepotMutex);
+			for (Uint32 i = count; i < mPageSize; ++i)
+				mDepot.push_back(slots + mPageSize - 1 - i);
+		}
+
+		return true;
+	}
+
+	/* Move a batch of slots from a full cache to the depot */
+	void flush(Cache* cache)
+	{
+		std::lock_guard<std::mutex> lock(mDepotMutex);
+
+		mDepot.insert(mDepot.end(), cache->mSlots, cache->mSlots + BatchSize);
+		memmove(cache->mSlots, cache->mSlots + BatchSize, (cache->mCount - BatchSize) * sizeof(T*));
+		cache->mCount -= BatchSize;
+	}
+
+	/* Take a single slot for threads that don't have a cache */
+	T* takeSlot()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mDepotMutex);
+			if (mDepot.size())
+			{
+				T* ptr = mDepot.back();
+				mDepot.pop_back();
+				return ptr;
+			}
+		}
+
+		T* slots = allocPage();
+		if (!slots) return 0;
+
+		std::lock_guard<std::mutex> lock(mDepotMutex);
+		for (Uint32 i = 1; i < mPageSize; ++i)
+			mDepot.push_back(slots + i);
+
+		return slots;
+	}
+
+	/* Allocate a page and add it to the page list */
+	T* allocPage()
+	{
+		Uint32 align = alignof(T) > 64 ? (Uint32)alignof(T) : 64;
+		Page* page = (Page*)aligned_alloc(getSlotOffset() + mPageSize * sizeof(T), align);
+		if (!page) return 0;
+
+		// Pages are only removed when the pool is freed, so a plain compare and swap is enough
+		page->mNext = mPages.load(std::memory_order_relaxed);
+		while (!mPages.compare_exchange_weak(page->mNext, page, std::memory_order_release, std::memory_order_relaxed));
+
+		return getSlots(page);
+	}
+
+	/* Call destructors of all live objects. Any slot that isn't in a cache or the depot is live */
+	void destroyObjects()
+	{
+		std::vector<T*> freeSlots;
+		{
+			// Destructors run outside the lock, since they may use the pool
+			std::lock_guard<std::mutex> lock(mDepotMutex);
+
+			freeSlots = mDepot;
+			for (Uint32 i = 0; i < MaxThreads; ++i)
+			{
+				if (mCaches[i])
+					freeSlots.insert(freeSlots.end(), mCaches[i]->mSlots, mCaches[i]->mSlots + mCaches[i]->mCount);
+			}
+		}
+
+		std::sort(freeSlots.begin(), freeSlots.end());
+
+		for (Page* page = mPages.load(); page; page = page->mNext)
+		{
+			T* slots = getSlots(page);
+			for (Uint32 i = 0; i < mPageSize; ++i)
+			{
+				if (!std::binary_search(freeSlots.begin(), freeSlots.end(), slots + i))
+					(slots + i)->~T();
+			}
+		}
+	}
+
 private:
-	/* Ptr to data */
-	T* mStart;
-	/* Current page */
-	T* mCurrent;
-	/* Last page */
-	T* mLast;
-	/* Page size */
+	/* List of all pages */
+	std::atomic<Page*> mPages;
+	/* Page size (number of objects per page) */
 	Uint32 mPageSize;
+	/* Per thread caches, indexed by thread index */
+	Cache* mCaches[MaxThreads];
+	/* Shared free slots */
+	std::vector<T*> mDepot;
+	/* Protects the depot */
+	std::mutex mDepotMutex;
 };
 
 // ============================================================================
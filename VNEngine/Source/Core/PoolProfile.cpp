@@ -0,0 +1,59 @@
+#include <Core/PoolProfile.h>
+
+#include <cstdlib>
+#include <fstream>
+
+using namespace vne;
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool PoolProfile::load(const std::string& fname)
+{
+	std::ifstream file(fname);
+	if (!file.is_open()) return false;
+
+	std::string line;
+	while (std::getline(file, line))
+	{
+		// Scene and type names can contain spaces, so entries are split by tabs
+		size_t first = line.find('\t');
+		size_t second = line.find('\t', first + 1);
+		if (first == std::string::npos || second == std::string::npos) continue;
+
+		Uint32 count = (Uint32)strtoul(line.c_str() + second + 1, 0, 10);
+		record(line.substr(0, first), line.substr(first + 1, second - first - 1), count);
+	}
+
+	return true;
+}
+
+bool PoolProfile::save(const std::string& fname) const
+{
+	std::ofstream file(fname);
+	if (!file.is_open()) return false;
+
+	for (auto it = mScenes.begin(); it != mScenes.end(); ++it)
+	{
+		for (auto count = it->second.begin(); count != it->second.end(); ++count)
+			file << it->first << '\t' << count->first << '\t' << count->second << '\n';
+	}
+
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void PoolProfile::record(const std::string& scene, const std::string& type, Uint32 count)
+{
+	Uint32& peak = mScenes[scene][type];
+	if (count > peak)
+		peak = count;
+}
+
+const PoolProfile::Counts* PoolProfile::getCounts(const std::string& scene) const
+{
+	auto it = mScenes.find(scene);
+	return it != mScenes.end() ? &it->second : 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,68 @@
+#ifndef POOL_PROFILE_H
+#define POOL_PROFILE_H
+
+#include <Core/DataTypes.h>
+
+#include <string>
+#include <unordered_map>
+
+namespace vne
+{
+
+// ============================================================================
+
+/// <summary>
+/// Peak object counts of each scene's pools, recorded during a run and saved to a file.
+/// The next run loads the file and uses the counts to reserve pool pages when a scene starts.
+/// File format is one "scene type count" entry per line, separated by tabs
+/// </summary>
+class PoolProfile
+{
+public:
+	/// <summary>
+	/// Map of pooled type names to peak object counts
+	/// </summary>
+	typedef std::unordered_map<std::string, Uint32> Counts;
+
+public:
+	/// <summary>
+	/// Load profile from a file. Entries are merged with any that already exist
+	/// </summary>
+	/// <param name="fname">File path</param>
+	/// <returns>True if the file was loaded</returns>
+	bool load(const std::string& fname);
+
+	/// <summary>
+	/// Save profile to a file
+	/// </summary>
+	/// <param name="fname">File path</param>
+	/// <returns>True if the file was saved</returns>
+	bool save(const std::string& fname) const;
+
+	/// <summary>
+	/// Record the peak object count of a pool. Only the highest count is kept
+	/// </summary>
+	/// <param name="scene">Scene name</param>
+	/// <param name="type">Pooled type name</param>
+	/// <param name="count">Peak object count</param>
+	void record(const std::string& scene, const std::string& type, Uint32 count);
+
+	/// <summary>
+	/// Get the peak object counts of a scene
+	/// </summary>
+	/// <param name="scene">Scene name</param>
+	/// <returns>Counts or null if the scene has no entries</returns>
+	const Counts* getCounts(const std::string& scene) const;
+
+private:
+	/// <summary>
+	/// Map of scene names to counts
+	/// </summary>
+	std::unordered_map<std::string, Counts> mScenes;
+};
+
+// ============================================================================
+
+}
+
+#endif
@@ -0,0 +1,134 @@
+#include <Core/PoolStats.h>
+
+#include <algorithm>
+#include <mutex>
+#include <vector>
+
+using namespace vne;
+
+///////////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+/* Registered stats, kept in a function so pools in static storage can register safely */
+std::vector<PoolStats*>& getRegistry()
+{
+	static std::vector<PoolStats*> registry;
+	return registry;
+}
+
+std::mutex& getRegistryMutex()
+{
+	static std::mutex mutex;
+	return mutex;
+}
+
+/* Write a string with JSON escapes */
+void writeString(std::ostream& stream, const char* str)
+{
+	stream << '"';
+	for (; str && *str; ++str)
+	{
+		if (*str == '"' || *str == '\\')
+			stream << '\\';
+		stream << *str;
+	}
+	stream << '"';
+}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+PoolStats::PoolStats() :
+	mName			(""),
+	mObjectSize		(0),
+	mPageSize		(0),
+	mNumLive		(0),
+	mPeakLive		(0),
+	mNumPages		(0),
+	mBytesReserved	(0),
+	mNumCreates		(0),
+	mNumFrees		(0),
+	mNumPageAllocs	(0)
+{
+
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void PoolStatsRegistry::add(PoolStats* stats)
+{
+	std::lock_guard<std::mutex> lock(getRegistryMutex());
+	getRegistry().push_back(stats);
+}
+
+void PoolStatsRegistry::remove(PoolStats* stats)
+{
+	std::lock_guard<std::mutex> lock(getRegistryMutex());
+
+	std::vector<PoolStats*>& registry = getRegistry();
+	auto it = std::find(registry.begin(), registry.end(), stats);
+	if (it != registry.end())
+		registry.erase(it);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void PoolStatsRegistry::dumpJson(std::ostream& stream, const char* label)
+{
+	std::lock_guard<std::mutex> lock(getRegistryMutex());
+
+	stream << "{\"label\":";
+	writeString(stream, label);
+	stream << ",\"pools\":[";
+
+	std::vector<PoolStats*>& registry = getRegistry();
+	for (Uint32 i = 0; i < registry.size(); ++i)
+	{
+		PoolStats* stats = registry[i];
+
+		if (i) stream << ',';
+		stream << "{\"name\":";
+		writeString(stream, stats->mName);
+		stream <<
+			",\"objectSize\":" << stats->mObjectSize <<
+			",\"pageSize\":" << stats->mPageSize <<
+			",\"live\":" << stats->mNumLive <<
+			",\"peakLive\":" << stats->mPeakLive <<
+			",\"pages\":" << stats->mNumPages <<
+			",\"bytesReserved\":" << stats->mBytesReserved <<
+			",\"creates\":" << stats->mNumCreates <<
+			",\"frees\":" << stats->mNumFrees <<
+			",\"pageAllocs\":" << stats->mNumPageAllocs << '}';
+	}
+
+	stream << "]}\n";
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+PoolStats PoolStatsRegistry::getTotals()
+{
+	std::lock_guard<std::mutex> lock(getRegistryMutex());
+
+	PoolStats totals;
+	totals.mName = "total";
+
+	std::vector<PoolStats*>& registry = getRegistry();
+	for (Uint32 i = 0; i < registry.size(); ++i)
+	{
+		PoolStats* stats = registry[i];
+
+		totals.mNumLive += stats->mNumLive;
+		totals.mPeakLive += stats->mPeakLive;
+		totals.mNumPages += stats->mNumPages;
+		totals.mBytesReserved += stats->mBytesReserved;
+		totals.mNumCreates += stats->mNumCreates;
+		totals.mNumFrees += stats->mNumFrees;
+		totals.mNumPageAllocs += stats->mNumPageAllocs;
+	}
+
+	return totals;
+}
+
+///////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,123 @@
+#ifndef POOL_STATS_H
+#define POOL_STATS_H
+
+#include <Core/DataTypes.h>
+
+#include <ostream>
+
+/* Pool counters are on in debug builds, define VNE_POOL_STATS to turn them on in release.
+   Pools have the same layout either way, it only decides whether the counters are updated */
+#if defined(_DEBUG) && !defined(VNE_POOL_STATS)
+#define VNE_POOL_STATS
+#endif
+
+#ifdef VNE_POOL_STATS
+#define POOL_STAT(x) x
+#else
+#define POOL_STAT(x)
+#endif
+
+namespace vne
+{
+
+// ============================================================================
+
+/// <summary>
+/// Usage counters of a single object pool
+/// </summary>
+struct PoolStats
+{
+	PoolStats();
+
+	/// <summary>
+	/// Name of the pool, used when dumping
+	/// </summary>
+	const char* mName;
+
+	/// <summary>
+	/// Size of a single object in bytes
+	/// </summary>
+	Uint32 mObjectSize;
+
+	/// <summary>
+	/// Number of objects per page
+	/// </summary>
+	Uint32 mPageSize;
+
+	/// <summary>
+	/// Number of objects that are currently alive
+	/// </summary>
+	Uint64 mNumLive;
+
+	/// <summary>
+	/// Highest number of live objects seen
+	/// </summary>
+	Uint64 mPeakLive;
+
+	/// <summary>
+	/// Number of pages currently allocated
+	/// </summary>
+	Uint64 mNumPages;
+
+	/// <summary>
+	/// Number of bytes reserved by all pages
+	/// </summary>
+	Uint64 mBytesReserved;
+
+	/// <summary>
+	/// Total number of objects created
+	/// </summary>
+	Uint64 mNumCreates;
+
+	/// <summary>
+	/// Total number of objects freed
+	/// </summary>
+	Uint64 mNumFrees;
+
+	/// <summary>
+	/// Total number of page allocations
+	/// </summary>
+	Uint64 mNumPageAllocs;
+};
+
+// ============================================================================
+
+/// <summary>
+/// List of the stats of every live pool, so they can all be dumped at once.
+/// Pools add themselves when they are created and remove themselves when destroyed
+/// </summary>
+class PoolStatsRegistry
+{
+public:
+	/// <summary>
+	/// Add stats to the registry
+	/// </summary>
+	/// <param name="stats">Stats to add</param>
+	static void add(PoolStats* stats);
+
+	/// <summary>
+	/// Remove stats from the registry
+	/// </summary>
+	/// <param name="stats">Stats to remove</param>
+	static void remove(PoolStats* stats);
+
+	/// <summary>
+	/// Write the stats of all registered pools as a single line of JSON
+	/// </summary>
+	/// <param name="stream">Output stream</param>
+	/// <param name="label">Label added to the output (i.e. the current scene)</param>
+	static void dumpJson(std::ostream& stream, const char* label = "");
+
+	/// <summary>
+	/// Get the sum of the counters of all registered pools.
+	/// The peak count is the sum of each pool's peak, so it is an upper bound
+	/// </summary>
+	/// <returns>Summed stats</returns>
+	static PoolStats getTotals();
+};
+
+// ============================================================================
+
+}
+
+#endif
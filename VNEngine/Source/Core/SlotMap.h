@@ -0,0 +1,328 @@
+#ifndef SLOT_MAP_H
+#define SLOT_MAP_H
+
+#include <Core/DataTypes.h>
+#include <Core/ObjectPool.h>
+
+#include <vector>
+
+namespace vne
+{
+
+// ============================================================================
+
+/// <summary>
+/// 32-bit handle to an object in a slot map.
+/// The lower bits store the slot index and the upper bits store the slot generation,
+/// so a handle to an object that was freed can be detected even after its slot is reused.
+/// A handle with a value of 0 is a null handle
+/// </summary>
+template <typename T>
+class Handle
+{
+public:
+	/// <summary>
+	/// Number of bits used for the slot index
+	/// </summary>
+	static const Uint32 IndexBits = 20;
+
+	/// <summary>
+	/// Mask for the slot index
+	/// </summary>
+	static const Uint32 IndexMask = (1u << IndexBits) - 1;
+
+	/// <summary>
+	/// Mask for the generation (after it is shifted down)
+	/// </summary>
+	static const Uint32 GenerationMask = (1u << (32 - IndexBits)) - 1;
+
+public:
+	Handle() :
+		mValue		(0)
+	{ }
+
+	explicit Handle(Uint32 value) :
+		mValue		(value)
+	{ }
+
+	Handle(Uint32 index, Uint32 generation) :
+		mValue		((generation << IndexBits) | (index & IndexMask))
+	{ }
+
+	/// <summary>
+	/// Get the slot index
+	/// </summary>
+	/// <returns>Slot index</returns>
+	Uint32 getIndex() const { return mValue & IndexMask; }
+
+	/// <summary>
+	/// Get the slot generation
+	/// </summary>
+	/// <returns>Generation</returns>
+	Uint32 getGeneration() const { return mValue >> IndexBits; }
+
+	/// <summary>
+	/// Get the raw handle value
+	/// </summary>
+	/// <returns>Handle value</returns>
+	Uint32 getValue() const { return mValue; }
+
+	/// <summary>
+	/// Returns true if this is a null handle
+	/// </summary>
+	/// <returns>Boolean</returns>
+	bool isNull() const { return mValue == 0; }
+
+	bool operator==(const Handle& other) const { return mValue == other.mValue; }
+	bool operator!=(const Handle& other) const { return mValue != other.mValue; }
+
+private:
+	/// <summary>
+	/// Generation and index
+	/// </summary>
+	Uint32 mValue;
+};
+
+// ============================================================================
+
+/// <summary>
+/// Container that hands out generation checked handles to its objects.
+/// Objects are stored in an object pool, so pointers to them stay valid until they are freed.
+/// A dense list of live objects is kept for iteration
+/// </summary>
+template <typename T>
+class SlotMap
+{
+public:
+	SlotMap() :
+		mFreeSlot		(NoSlot)
+	{ }
+
+	~SlotMap()
+	{
+		clear();
+	}
+
+	SlotMap(const SlotMap& other) = delete;
+	SlotMap& operator=(const SlotMap& other) = delete;
+
+	/// <summary>
+	/// Create a new object and return its handle.
+	/// Returns a null handle if all slots are used or the object couldn't be allocated
+	/// </summary>
+	template <typename... Args>
+	Handle<T> create(Args&&... args)
+	{
+		Uint32 index;
+
+		// Reuse a free slot if there is one
+		if (mFreeSlot != NoSlot)
+		{
+			index = mFreeSlot;
+			mFreeSlot = mSlots[index].mIndex;
+		}
+		else
+		{
+			if (mSlots.size() > Handle<T>::IndexMask) return Handle<T>();
+
+			index = (Uint32)mSlots.size();
+			mSlots.push_back(Slot());
+		}
+
+		Slot& slot = mSlots[index];
+		slot.mObject = mPool.create(std::forward<Args>(args)...);
+		if (!slot.mObject)
+		{
+			// Give the slot back
+			releaseSlot(index);
+			return Handle<T>();
+		}
+
+		slot.mIndex = (Uint32)mObjects.size();
+
+		// Add to dense list
+		mObjects.push_back(slot.mObject);
+		mObjectSlots.push_back(index);
+
+		return Handle<T>(index, slot.mGeneration);
+	}
+
+	/// <summary>
+	/// Free the object a handle refers to. Stale handles are ignored
+	/// </summary>
+	/// <param name="handle">Object handle</param>
+	void free(Handle<T> handle)
+	{
+		if (!isValid(handle)) return;
+
+		Uint32 index = handle.getIndex();
+		Slot& slot = mSlots[index];
+
+		mPool.free(slot.mObject);
+
+		// Move last object into the hole in the dense list
+		Uint32 dense = slot.mIndex;
+		mObjects[dense] = mObjects.back();
+		mObjectSlots[dense] = mObjectSlots.back();
+		mSlots[mObjectSlots[dense]].mIndex = dense;
+		mObjects.pop_back();
+		mObjectSlots.pop_back();
+
+		// Invalidate existing handles and add slot to free list
+		releaseSlot(index);
+	}
+
+	/// <summary>
+	/// Free all objects. All existing handles become stale
+	/// </summary>
+	void clear()
+	{
+		for (Uint32 i = 0; i < mObjectSlots.size(); ++i)
+			releaseSlot(mObjectSlots[i]);
+
+		mObjects.clear();
+		mObjectSlots.clear();
+		mPool.free();
+	}
+
+	/// <summary>
+	/// Get the object a handle refers to.
+	/// Returns NULL if the handle is null or stale
+	/// </summary>
+	/// <param name="handle">Object handle</param>
+	/// <returns>Pointer to object</returns>
+	T* get(Handle<T> handle) const
+	{
+		return isValid(handle) ? mSlots[handle.getIndex()].mObject : 0;
+	}
+
+	/// <summary>
+	/// Returns true if the handle refers to a live object
+	/// </summary>
+	/// <param name="handle">Object handle</param>
+	/// <returns>Boolean</returns>
+	bool isValid(Handle<T> handle) const
+	{
+		Uint32 index = handle.getIndex();
+		return
+			index < mSlots.size() &&
+			mSlots[index].mObject &&
+			mSlots[index].mGeneration == handle.getGeneration();
+	}
+
+	/// <summary>
+	/// Get the number of live objects
+	/// </summary>
+	/// <returns>Number of objects</returns>
+	Uint32 size() const
+	{
+		return (Uint32)mObjects.size();
+	}
+
+	/// <summary>
+	/// Get the dense list of live objects
+	/// </summary>
+	/// <returns>List of object pointers</returns>
+	const std::vector<T*>& getObjects() const
+	{
+		return mObjects;
+	}
+
+	/// <summary>
+	/// Get the handle of an object in the dense list
+	/// </summary>
+	/// <param name="i">Index in the dense list</param>
+	/// <returns>Object handle</returns>
+	Handle<T> getHandle(Uint32 i) const
+	{
+		Uint32 index = mObjectSlots[i];
+		return Handle<T>(index, mSlots[index].mGeneration);
+	}
+
+	/// <summary>
+	/// Call a function on every live object
+	/// </summary>
+	template <typename F>
+	void forEach(F func)
+	{
+		for (Uint32 i = 0; i < mObjects.size(); ++i)
+			func(mObjects[i]);
+	}
+
+	/// <summary>
+	/// Get the object pool the objects are stored in
+	/// </summary>
+	/// <returns>Object pool</returns>
+	ObjectPool<T>& getPool()
+	{
+		return mPool;
+	}
+
+private:
+	/* Marks the end of the free slot list */
+	static const Uint32 NoSlot = 0xFFFFFFFF;
+
+	/* Slot entry */
+	struct Slot
+	{
+		Slot() :
+			mObject(0),
+			mIndex(0),
+			mGeneration(1)
+		{ }
+
+		/* Object pointer (NULL if the slot is free) */
+		T* mObject;
+		/* Index in the dense list if used, next free slot if free */
+		Uint32 mIndex;
+		/* Incremented every time the slot is freed */
+		Uint32 mGeneration;
+	};
+
+	/* Invalidate a slot and add it to the free list */
+	void releaseSlot(Uint32 index)
+	{
+		Slot& slot = mSlots[index];
+		slot.mObject = 0;
+
+		// Generation 0 is skipped so a null handle is never valid
+		slot.mGeneration = (slot.mGeneration + 1) & Handle<T>::GenerationMask;
+		if (!slot.mGeneration)
+			slot.mGeneration = 1;
+
+		slot.mIndex = mFreeSlot;
+		mFreeSlot = index;
+	}
+
+private:
+	/// <summary>
+	/// Object storage
+	/// </summary>
+	ObjectPool<T> mPool;
+
+	/// <summary>
+	/// Slot entries, indexed by handle index
+	/// </summary>
+	std::vector<Slot> mSlots;
+
+	/// <summary>
+	/// Dense list of live objects
+	/// </summary>
+	std::vector<T*> mObjects;
+
+	/// <summary>
+	/// Slot index of each object in the dense list
+	/// </summary>
+	std::vector<Uint32> mObjectSlots;
+
+	/// <summary>
+	/// First free slot
+	/// </summary>
+	Uint32 mFreeSlot;
+};
+
+// ============================================================================
+
+}
+
+#endif
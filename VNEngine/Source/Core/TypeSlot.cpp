@@ -0,0 +1,16 @@
+#include <Core/TypeSlot.h>
+
+using namespace vne;
+
+///////////////////////////////////////////////////////////////////////////////
+
+std::atomic<Uint32> TypeSlot::sNumSlots(0);
+
+///////////////////////////////////////////////////////////////////////////////
+
+Uint32 TypeSlot::getNumSlots()
+{
+	return sNumSlots;
+}
+
+///////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,48 @@
+#ifndef TYPE_SLOT_H
+#define TYPE_SLOT_H
+
+#include <Core/DataTypes.h>
+
+#include <atomic>
+
+namespace vne
+{
+
+// ============================================================================
+
+/// <summary>
+/// Assigns each type a small unique index the first time it is requested.
+/// The indices are dense, so they can be used to index arrays of per-type data
+/// </summary>
+class TypeSlot
+{
+public:
+	/// <summary>
+	/// Get the slot index of type T
+	/// </summary>
+	/// <returns>Slot index</returns>
+	template <typename T>
+	static Uint32 get()
+	{
+		static const Uint32 slot = sNumSlots++;
+		return slot;
+	}
+
+	/// <summary>
+	/// Get the number of slots that have been assigned
+	/// </summary>
+	/// <returns>Number of slots</returns>
+	static Uint32 getNumSlots();
+
+private:
+	/// <summary>
+	/// Number of assigned slots
+	/// </summary>
+	static std::atomic<Uint32> sNumSlots;
+};
+
+// ============================================================================
+
+}
+
+#endif
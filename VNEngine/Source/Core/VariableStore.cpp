@@ -0,0 +1,141 @@
+#include <Core/VariableStore.h>
+
+#include <type_traits>
+
+using namespace vne;
+
+///////////////////////////////////////////////////////////////////////////////
+
+Uint32 VariableStore::add(NameId name)
+{
+	auto it = mSlots.find(name);
+	if (it != mSlots.end())
+		return it->second;
+
+	Uint32 slot = (Uint32)mValues.size();
+	mSlots[name] = slot;
+	mValues.push_back(Variant());
+	mNames.push_back(name);
+
+	if (mDirty.size() * 32 < mValues.size())
+		mDirty.push_back(0);
+
+	return slot;
+}
+
+Uint32 VariableStore::getSlot(NameId name) const
+{
+	auto it = mSlots.find(name);
+	return it != mSlots.end() ? it->second : InvalidSlot;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void VariableStore::clearDirty()
+{
+	for (Uint32 i = 0; i < mDirty.size(); ++i)
+		mDirty[i] = 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+Uint32 VariableStore::write(std::ostream& stream, bool dirtyOnly) const
+{
+	std::vector<Uint32> slots;
+	if (dirtyOnly)
+		forEachDirty([&](Uint32 slot) { slots.push_back(slot); });
+	else
+	{
+		for (Uint32 i = 0; i < mValues.size(); ++i)
+			slots.push_back(i);
+	}
+
+	Uint32 count = (Uint32)slots.size();
+	stream.write((const char*)&count, sizeof(Uint32));
+
+	for (Uint32 i = 0; i < slots.size(); ++i)
+	{
+		writeName(stream, mNames[slots[i]]);
+		writeValue(stream, mValues[slots[i]]);
+	}
+
+	return count;
+}
+
+bool VariableStore::read(std::istream& stream)
+{
+	Uint32 count = 0;
+	if (!stream.read((char*)&count, sizeof(Uint32))) return false;
+
+	for (Uint32 i = 0; i < count; ++i)
+	{
+		NameId name;
+		Variant val;
+		if (!readName(stream, name) || !readValue(stream, val)) return false;
+
+		mValues[add(name)] = val;
+	}
+
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void VariableStore::clear()
+{
+	mValues.clear();
+	mNames.clear();
+	mDirty.clear();
+	mSlots.clear();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void VariableStore::writeName(std::ostream& stream, NameId name)
+{
+	// Length followed by UTF-32 code points
+	const sf::String& str = name.getString();
+	Uint32 size = (Uint32)str.getSize();
+	stream.write((const char*)&size, sizeof(Uint32));
+	stream.write((const char*)str.getData(), size * sizeof(Uint32));
+}
+
+bool VariableStore::readName(std::istream& stream, NameId& name)
+{
+	Uint32 size = 0;
+	if (!stream.read((char*)&size, sizeof(Uint32)) || size > MaxNameSize) return false;
+
+	std::vector<Uint32> data(size);
+	if (size && !stream.read((char*)&data[0], size * sizeof(Uint32))) return false;
+
+	name = NameId(sf::String::fromUtf32(data.begin(), data.end()));
+	return true;
+}
+
+void VariableStore::writeValue(std::ostream& stream, const Variant& val)
+{
+	// Setting a variant clears the bytes its type doesn't use, so nothing stale is written
+	static_assert(std::is_trivially_copyable<Variant>::value, "Variants are written as raw bytes");
+
+	stream.write((const char*)&val, sizeof(Variant));
+	if (val.getType() == Variant::Name)
+		writeName(stream, val.get<NameId>());
+}
+
+bool VariableStore::readValue(std::istream& stream, Variant& val)
+{
+	if (!stream.read((char*)&val, sizeof(Variant))) return false;
+
+	if (val.getType() == Variant::Name)
+	{
+		NameId name;
+		if (!readName(stream, name)) return false;
+		val = name;
+	}
+	else if (!val.isValid())
+		return false;
+
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
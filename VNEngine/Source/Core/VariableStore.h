@@ -0,0 +1,298 @@
+#ifndef VARIABLE_STORE_H
+#define VARIABLE_STORE_H
+
+#include <Core/DataTypes.h>
+#include <Core/Math.h>
+#include <Core/NameId.h>
+#include <Core/Variant.h>
+
+#include <istream>
+#include <ostream>
+#include <unordered_map>
+#include <vector>
+
+namespace vne
+{
+
+// ============================================================================
+
+template <typename T>
+class VariableHandle;
+
+/// <summary>
+/// Game variables stored in a contiguous array.
+/// Each variable is registered once by name and given a dense integer slot, after that it can be read and written by slot.
+/// Every change is recorded in a dirty bitset, so a save only has to write the variables that changed since the last one
+/// </summary>
+class VariableStore
+{
+public:
+	/// <summary>
+	/// Slot returned when a name isn't registered
+	/// </summary>
+	static const Uint32 InvalidSlot = 0xFFFFFFFF;
+
+	/// <summary>
+	/// Longest name that can be read back, in code points. Longer lengths in a file are treated as damage
+	/// </summary>
+	static const Uint32 MaxNameSize = 65536;
+
+public:
+	/// <summary>
+	/// Register a variable and return its slot.
+	/// Returns the existing slot if the name is already registered
+	/// </summary>
+	/// <param name="name">Variable name</param>
+	/// <returns>Slot</returns>
+	Uint32 add(NameId name);
+
+	/// <summary>
+	/// Get the slot of a variable
+	/// </summary>
+	/// <param name="name">Variable name</param>
+	/// <returns>Slot, or InvalidSlot if the variable isn't registered</returns>
+	Uint32 getSlot(NameId name) const;
+
+	/// <summary>
+	/// Returns true if the variable is registered
+	/// </summary>
+	/// <param name="name">Variable name</param>
+	/// <returns>Boolean</returns>
+	bool exists(NameId name) const
+	{
+		return getSlot(name) != InvalidSlot;
+	}
+
+	/// <summary>
+	/// Get a typed handle to a variable, registering it if needed
+	/// </summary>
+	/// <param name="name">Variable name</param>
+	/// <returns>Handle</returns>
+	template <typename T>
+	VariableHandle<T> getHandle(NameId name)
+	{
+		return VariableHandle<T>(this, add(name));
+	}
+
+	/// <summary>
+	/// Get the value in a slot
+	/// </summary>
+	/// <param name="slot">Slot</param>
+	/// <returns>Value</returns>
+	const Variant& get(Uint32 slot) const
+	{
+		return mValues[slot];
+	}
+
+	/// <summary>
+	/// Set the value in a slot. The slot is marked dirty if the value changed
+	/// </summary>
+	/// <param name="slot">Slot</param>
+	/// <param name="val">New value</param>
+	void set(Uint32 slot, const Variant& val)
+	{
+		Variant& current = mValues[slot];
+		if (current.getType() != val.getType() || current != val)
+		{
+			current = val;
+			mDirty[slot / 32] |= 1u << (slot % 32);
+		}
+	}
+
+	/// <summary>
+	/// Get the name of a slot
+	/// </summary>
+	/// <param name="slot">Slot</param>
+	/// <returns>Name</returns>
+	NameId getName(Uint32 slot) const
+	{
+		return mNames[slot];
+	}
+
+	/// <summary>
+	/// Get the number of registered variables
+	/// </summary>
+	/// <returns>Number of variables</returns>
+	Uint32 getNumVariables() const
+	{
+		return (Uint32)mValues.size();
+	}
+
+	/// <summary>
+	/// Returns true if the slot changed since the dirty bits were last cleared
+	/// </summary>
+	/// <param name="slot">Slot</param>
+	/// <returns>Boolean</returns>
+	bool isDirty(Uint32 slot) const
+	{
+		return (mDirty[slot / 32] >> (slot % 32)) & 1;
+	}
+
+	/// <summary>
+	/// Clear all dirty bits
+	/// </summary>
+	void clearDirty();
+
+	/// <summary>
+	/// Call a function with the slot of every dirty variable, in slot order
+	/// </summary>
+	/// <param name="func">Function that takes a slot</param>
+	template <typename F>
+	void forEachDirty(F func) const
+	{
+		for (Uint32 i = 0; i < mDirty.size(); ++i)
+		{
+			for (Uint32 bits = mDirty[i]; bits; bits &= bits - 1)
+				func(i * 32 + countTrailingZeros(bits));
+		}
+	}
+
+	/// <summary>
+	/// Write variables to a binary stream.
+	/// Variables are written by name, so saves stay valid when the registration order changes
+	/// </summary>
+	/// <param name="stream">Output stream</param>
+	/// <param name="dirtyOnly">Only write the variables that changed since the dirty bits were last cleared</param>
+	/// <returns>Number of variables written</returns>
+	Uint32 write(std::ostream& stream, bool dirtyOnly = false) const;
+
+	/// <summary>
+	/// Read variables written by write(), registering any that don't exist.
+	/// Blocks can be read one after another, so a full save followed by change only saves gives the latest values.
+	/// Read values are not marked dirty
+	/// </summary>
+	/// <param name="stream">Input stream</param>
+	/// <returns>True if the block was read without errors</returns>
+	bool read(std::istream& stream);
+
+	/// <summary>
+	/// Remove all variables
+	/// </summary>
+	void clear();
+
+	/// <summary>
+	/// Write a name as its string, since name ids change between runs
+	/// </summary>
+	/// <param name="stream">Output stream</param>
+	/// <param name="name">Name</param>
+	static void writeName(std::ostream& stream, NameId name);
+
+	/// <summary>
+	/// Read a name written by writeName(). Fails if the name is longer than MaxNameSize
+	/// </summary>
+	/// <param name="stream">Input stream</param>
+	/// <param name="name">Name that was read</param>
+	/// <returns>True if there were no errors</returns>
+	static bool readName(std::istream& stream, NameId& name);
+
+	/// <summary>
+	/// Write a value, names are written as strings
+	/// </summary>
+	/// <param name="stream">Output stream</param>
+	/// <param name="val">Value</param>
+	static void writeValue(std::ostream& stream, const Variant& val);
+
+	/// <summary>
+	/// Read a value written by writeValue()
+	/// </summary>
+	/// <param name="stream">Input stream</param>
+	/// <param name="val">Value that was read</param>
+	/// <returns>True if there were no errors</returns>
+	static bool readValue(std::istream& stream, Variant& val);
+
+private:
+	/// <summary>
+	/// Variable values, indexed by slot
+	/// </summary>
+	std::vector<Variant> mValues;
+
+	/// <summary>
+	/// Variable names, indexed by slot
+	/// </summary>
+	std::vector<NameId> mNames;
+
+	/// <summary>
+	/// One bit per slot, set when the value changes
+	/// </summary>
+	std::vector<Uint32> mDirty;
+
+	/// <summary>
+	/// Maps variable names to slots
+	/// </summary>
+	std::unordered_map<NameId, Uint32> mSlots;
+};
+
+// ============================================================================
+
+/// <summary>
+/// Typed accessor of a single variable in a variable store.
+/// Reading and writing through a handle doesn't look up the name
+/// </summary>
+template <typename T>
+class VariableHandle
+{
+public:
+	VariableHandle() :
+		mStore		(0),
+		mSlot		(VariableStore::InvalidSlot)
+	{ }
+
+	VariableHandle(VariableStore* store, Uint32 slot) :
+		mStore		(store),
+		mSlot		(slot)
+	{ }
+
+	/// <summary>
+	/// Get the variable value
+	/// </summary>
+	/// <returns>Value</returns>
+	T get() const
+	{
+		return mStore->get(mSlot).get<T>();
+	}
+
+	/// <summary>
+	/// Set the variable value
+	/// </summary>
+	/// <param name="val">New value</param>
+	void set(const T& val)
+	{
+		mStore->set(mSlot, Variant(val));
+	}
+
+	operator T() const { return get(); }
+
+	VariableHandle& operator=(const T& val)
+	{
+		set(val);
+		return *this;
+	}
+
+	/// <summary>
+	/// Get the slot of the variable
+	/// </summary>
+	/// <returns>Slot</returns>
+	Uint32 getSlot() const { return mSlot; }
+
+	/// <summary>
+	/// Returns true if the handle points to a variable
+	/// </summary>
+	bool isValid() const { return mStore != 0; }
+
+private:
+	/// <summary>
+	/// Store the variable is in
+	/// </summary>
+	VariableStore* mStore;
+
+	/// <summary>
+	/// Slot of the variable
+	/// </summary>
+	Uint32 mSlot;
+};
+
+// ============================================================================
+
+}
+
+#endif
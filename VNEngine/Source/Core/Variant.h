@@ -2,12 +2,20 @@
 #define VARIANT_H
 
 #include <Core/DataTypes.h>
+#include <Core/NameId.h>
+
+#include <limits.h>
+#include <string.h>
+#include <type_traits>
 
 namespace vne
 {
 
 // ============================================================================
 
+/// <summary>
+/// Tagged union that holds a single game variable value in 16 bytes
+/// </summary>
 class Variant
 {
 public:
@@ -54,88 +62,228 @@ public:
 		Vec3,
 
 		/// <summary>
-		/// Other unknown data type
+		/// 32-bit id of an interned string
+		/// </summary>
+		Name,
+
+		/// <summary>
+		/// Other unknown data type (trivially copyable, up to 12 bytes)
 		/// </summary>
 		Unknown
 	};
 
 public:
-	Variant() { memset(mData, 0, 64); }
+	Variant() :
+		mType(Unknown)
+	{
+		memset(mData, 0, sizeof(mData));
+	}
 
 	template <typename T>
-	Variant(const T& val) { *this = val; }
+	Variant(const T& val) { set(val); }
 
 	template <typename T>
-	T& operator=(const T& val)
+	Variant& operator=(const T& val)
+	{
+		set(val);
+		return *this;
+	}
+
+	/// <summary>
+	/// Get the value as type T. Numeric types are converted between each other,
+	/// any other type returns a default value unless it is the stored type
+	/// </summary>
+	template <typename T>
+	T get() const { return getValue((T*)0, std::is_arithmetic<T>()); }
+
+	template <typename T>
+	operator T() const { return get<T>(); }
+
+	/// <summary>
+	/// Create a variant that holds an interned string id
+	/// </summary>
+	static Variant fromNameId(Uint32 id)
+	{
+		Variant v;
+		v.setType(Name);
+		v.mUint = id;
+		return v;
+	}
+
+	/// <summary>
+	/// Get the interned string id, or 0 if the variant doesn't hold one
+	/// </summary>
+	Uint32 getNameId() const { return mType == Name ? mUint : 0; }
+
+	bool operator==(const Variant& other) const
+	{
+		if (mType == other.mType)
+		{
+			switch (mType)
+			{
+			case Bool:		return mBool == other.mBool;
+			case Char:		return mChar == other.mChar;
+			case Int:		return mInt == other.mInt;
+			case Uint:
+			case Name:		return mUint == other.mUint;
+			case Float:		return mFloat == other.mFloat;
+			case Double:	return getDouble() == other.getDouble();
+			case Vec2:		return mVec[0] == other.mVec[0] && mVec[1] == other.mVec[1];
+			case Vec3:		return mVec[0] == other.mVec[0] && mVec[1] == other.mVec[1] && mVec[2] == other.mVec[2];
+			default:		return memcmp(mData, other.mData, sizeof(mData)) == 0;
+			}
+		}
+
+		// Different numeric types are compared by value
+		if (isNumeric() && other.isNumeric())
+			return toNumber<double>() == other.toNumber<double>();
+
+		return false;
+	}
+
+	bool operator!=(const Variant& other) const { return !(*this == other); }
+
+	Type getType() const { return mType; }
+
+	/// <summary>
+	/// Returns true if the variant holds a bool, char, integer, or floating point value
+	/// </summary>
+	bool isNumeric() const { return mType <= Double; }
+
+	/// <summary>
+	/// Returns false if the type is out of range or a bool isn't 0 or 1 (used to check raw bytes loaded from a file)
+	/// </summary>
+	bool isValid() const
 	{
-		mType = Unknown;
-		memset(mData, 0, 64);
-		return (*reinterpret_cast<T*>(mData) = val);
+		if ((Uint32)mType > Unknown) return false;
+		return mType != Bool || mData[0] <= 1;
 	}
 
-	template <> bool& operator=(const bool& val)
+private:
+	/* Set the type and clear the value, so unused bytes never hold an old value */
+	void setType(Type type)
 	{
-		mType = Bool;
-		memset(mData, 0, 64);
-		return (*reinterpret_cast<bool*>(mData) = val);
+		mType = type;
+		memset(mData, 0, sizeof(mData));
 	}
 
-	template <> char& operator=(const char& val)
+	void set(bool val) { setType(Bool); mBool = val; }
+	void set(char val) { setType(Char); mChar = val; }
+	void set(int val) { setType(Int); mInt = val; }
+	void set(Uint32 val) { setType(Uint); mUint = val; }
+	void set(float val) { setType(Float); mFloat = val; }
+	void set(double val) { setType(Double); memcpy(mData, &val, sizeof(double)); }
+	void set(NameId val) { setType(Name); mUint = val.getId(); }
+
+	void set(const sf::Vector2f& val)
 	{
-		mType = Char;
-		memset(mData, 0, 64);
-		return (*reinterpret_cast<char*>(mData) = val);
+		setType(Vec2);
+		mVec[0] = val.x;
+		mVec[1] = val.y;
 	}
 
-	template <> int& operator=(const int& val)
+	void set(const sf::Vector3f& val)
 	{
-		mType = Int;
-		memset(mData, 0, 64);
-		return (*reinterpret_cast<int*>(mData) = val);
+		setType(Vec3);
+		mVec[0] = val.x;
+		mVec[1] = val.y;
+		mVec[2] = val.z;
 	}
 
-	template <> Uint32& operator=(const Uint32& val)
+	void set(const Variant& val)
 	{
-		mType = Uint;
-		memset(mData, 0, 64);
-		return (*reinterpret_cast<Uint32*>(mData) = val);
+		mType = val.mType;
+		memcpy(mData, val.mData, sizeof(mData));
 	}
 
-	template <> float& operator=(const float& val)
+	template <typename T>
+	void set(const T& val) { setValue(val, std::is_arithmetic<T>()); }
+
+	/* Other integer and floating point types are stored as the closest numeric type that holds the value */
+	template <typename T>
+	void setValue(const T& val, std::true_type)
 	{
-		mType = Float;
-		memset(mData, 0, 64);
-		return (*reinterpret_cast<float*>(mData) = val);
+		if (std::is_floating_point<T>::value)
+			set((double)val);
+		else if (std::is_signed<T>::value)
+		{
+			long long num = (long long)val;
+			if (num >= INT_MIN && num <= INT_MAX)
+				set((int)num);
+			else
+				set((double)num);
+		}
+		else
+		{
+			unsigned long long num = (unsigned long long)val;
+			if (num <= UINT_MAX)
+				set((Uint32)num);
+			else
+				set((double)num);
+		}
 	}
 
-	template <> double& operator=(const double& val)
+	/* Any other type is stored as raw bytes */
+	template <typename T>
+	void setValue(const T& val, std::false_type)
 	{
-		mType = Double;
-		memset(mData, 0, 64);
-		return (*reinterpret_cast<double*>(mData) = val);
+		static_assert(sizeof(T) <= sizeof(mData), "Variant can only hold types up to 12 bytes");
+		static_assert(std::is_trivially_copyable<T>::value, "Variant can only hold trivially copyable types");
+
+		setType(Unknown);
+		memcpy(mData, &val, sizeof(T));
 	}
 
-	template <> sf::Vector2f& operator=(const sf::Vector2f& val)
+	/* Numeric types */
+	template <typename T>
+	T getValue(T*, std::true_type) const { return toNumber<T>(); }
+
+	sf::Vector2f getValue(sf::Vector2f*, std::false_type) const
 	{
-		mType = Vec2;
-		memset(mData, 0, 64);
-		return (*reinterpret_cast<sf::Vector2f*>(mData) = val);
+		return mType == Vec2 || mType == Vec3 ? sf::Vector2f(mVec[0], mVec[1]) : sf::Vector2f();
 	}
 
-	template <> sf::Vector3f& operator=(const sf::Vector3f& val)
+	sf::Vector3f getValue(sf::Vector3f*, std::false_type) const
 	{
-		mType = Vec3;
-		memset(mData, 0, 64);
-		return (*reinterpret_cast<sf::Vector3f*>(mData) = val);
+		return mType == Vec3 ? sf::Vector3f(mVec[0], mVec[1], mVec[2]) : sf::Vector3f();
 	}
 
+	NameId getValue(NameId*, std::false_type) const { return NameId::fromId(getNameId()); }
+
+	Variant getValue(Variant*, std::false_type) const { return *this; }
+
+	/* Raw bytes of unknown types */
 	template <typename T>
-	operator T() const { return *reinterpret_cast<const T*>(mData); }
+	T getValue(T*, std::false_type) const
+	{
+		T val = T();
+		if (mType == Unknown)
+			memcpy(&val, mData, sizeof(T));
+		return val;
+	}
 
-	bool operator==(const Variant& other) { return memcmp(mData, other.mData, 64) == 0; }
-	bool operator!=(const Variant& other) { return memcmp(mData, other.mData, 64) != 0; }
+	/* Convert numeric value */
+	template <typename T>
+	T toNumber() const
+	{
+		switch (mType)
+		{
+		case Bool:		return (T)mBool;
+		case Char:		return (T)mChar;
+		case Int:		return (T)mInt;
+		case Uint:		return (T)mUint;
+		case Float:		return (T)mFloat;
+		case Double:	return (T)getDouble();
+		default:		return T();
+		}
+	}
 
-	Type getType() const { return mType; }
+	double getDouble() const
+	{
+		double val;
+		memcpy(&val, mData, sizeof(double));
+		return val;
+	}
 
 private:
 	/// <summary>
@@ -144,13 +292,24 @@ private:
 	Type mType;
 
 	/// <summary>
-	/// Buffer for data
+	/// Value, doubles are copied in and out of the bytes so the variant only needs 4 byte alignment
 	/// </summary>
-	Uint8 mData[64];
+	union
+	{
+		bool mBool;
+		char mChar;
+		int mInt;
+		Uint32 mUint;
+		float mFloat;
+		float mVec[3];
+		Uint8 mData[12];
+	};
 };
 
+static_assert(sizeof(Variant) == 16, "Variant should be 16 bytes");
+
 // ============================================================================
 
 }
 
-#endif
\ No newline at end of file
+#endif
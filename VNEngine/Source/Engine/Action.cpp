@@ -9,8 +9,10 @@ using namespace vne;
 // ============================================================================
 
 Action::Action() :
-	mScene			(0),
-	mIsComplete		(false)
+	mScene					(0),
+	mCompiledCondition		(0),
+	mIsComplete				(false),
+	mIsWaiting				(false)
 {
 
 }
@@ -32,6 +34,11 @@ void Action::setCondition(const std::function<bool()>& cond)
 	mCondition = cond;
 }
 
+void Action::setCondition(const Condition* cond)
+{
+	mCompiledCondition = cond;
+}
+
 void Action::setComplete(bool complete)
 {
 	mIsComplete = complete;
@@ -44,9 +51,32 @@ bool Action::isComplete() const
 
 bool Action::isConditionMet() const
 {
+	if (mCompiledCondition)
+		return mCompiledCondition->evaluate();
+
 	return !mCondition || (mCondition && mCondition());
 }
 
+bool Action::isReady() const
+{
+	return true;
+}
+
+Uint32 Action::prefetch()
+{
+	return 0;
+}
+
+void Action::setWaiting(bool waiting)
+{
+	mIsWaiting = waiting;
+}
+
+bool Action::isWaiting() const
+{
+	return mIsWaiting;
+}
+
 // ============================================================================
 
 void Action::update(float dt)
@@ -62,7 +92,8 @@ void Action::handleEvent(const sf::Event& e)
 // ============================================================================
 // ============================================================================
 
-ActionGroup::ActionGroup() :
+ActionGroup::ActionGroup(MemoryResource* resource) :
+	mActions			(resource),
 	mActionIndex		(-1),
 	mIsParallel			(false)
 {
@@ -82,7 +113,7 @@ void ActionGroup::run()
 	{
 		// Run all actions
 		for (Uint32 i = 0; i < mActions.size(); ++i)
-			mActions[i]->run();
+			mScene->runAction(mActions[i]);
 	}
 
 	// Complete if there are no actions to execute
@@ -102,7 +133,7 @@ void ActionGroup::update(float dt)
 
 			if (!actionComplete)
 				// Update if not complete
-				mActions[i]->update(dt);
+				mScene->updateAction(mActions[i], dt);
 
 			// Completion flag
 			complete &= actionComplete;
@@ -113,7 +144,7 @@ void ActionGroup::update(float dt)
 	else
 	{
 		if (mActionIndex >= 0 && mActionIndex < mActions.size())
-			mActions[mActionIndex]->update(dt);
+			mScene->updateAction(mActions[mActionIndex], dt);
 
 		// If the current action is completed or the index is negative
 		if (mActionIndex < 0 || (mActionIndex < mActions.size() && mActions[mActionIndex]->isComplete()))
@@ -124,7 +155,7 @@ void ActionGroup::update(float dt)
 
 			if (mActionIndex < mActions.size())
 				// Run action
-				mActions[mActionIndex]->run();
+				mScene->runAction(mActions[mActionIndex]);
 		}
 		else if (mActions[mActionIndex]->isComplete())
 			// Complete the group once all actions have run
@@ -132,6 +163,14 @@ void ActionGroup::update(float dt)
 	}
 }
 
+Uint32 ActionGroup::prefetch()
+{
+	for (Uint32 i = 0; i < mActions.size(); ++i)
+		mActions[i]->prefetch();
+
+	return 0;
+}
+
 void ActionGroup::handleEvent(const sf::Event& e)
 {
 	if (mIsParallel)
@@ -330,9 +369,27 @@ BackgroundAction::~BackgroundAction()
 
 // ============================================================================
 
+bool BackgroundAction::isReady() const
+{
+	return mTextureHandle.isDone();
+}
+
+Uint32 BackgroundAction::prefetch()
+{
+	mTextureHandle.request();
+	return mTextureHandle.isValid() ? 1 : 0;
+}
+
 void BackgroundAction::setTexture(sf::Texture* texture)
 {
 	mTexture = texture;
+	mTextureHandle = LoadHandle<sf::Texture>();
+}
+
+void BackgroundAction::setTexture(const LoadHandle<sf::Texture>& texture)
+{
+	mTexture = 0;
+	mTextureHandle = texture;
 }
 
 void BackgroundAction::setTransition(Transition effect)
@@ -349,6 +406,9 @@ void BackgroundAction::setDuration(float duration)
 
 void BackgroundAction::run()
 {
+	if (mTextureHandle.isValid())
+		mTexture = mTextureHandle.get();
+
 	NovelScene* scene = static_cast<NovelScene*>(mScene);
 	ImageBox* bg = scene->getBackground();
 	UI& ui = scene->getUI();
@@ -457,9 +517,27 @@ void ImageAction::setMode(Mode mode)
 	mMode = mode;
 }
 
+bool ImageAction::isReady() const
+{
+	return mTextureHandle.isDone();
+}
+
+Uint32 ImageAction::prefetch()
+{
+	mTextureHandle.request();
+	return mTextureHandle.isValid() ? 1 : 0;
+}
+
 void ImageAction::setTexture(sf::Texture* texture)
 {
 	mTexture = texture;
+	mTextureHandle = LoadHandle<sf::Texture>();
+}
+
+void ImageAction::setTexture(const LoadHandle<sf::Texture>& texture)
+{
+	mTexture = 0;
+	mTextureHandle = texture;
 }
 
 void ImageAction::setTransition(Transition effect)
@@ -481,6 +559,9 @@ void ImageAction::setImageBox(ImageBox* box)
 
 void ImageAction::run()
 {
+	if (mTextureHandle.isValid())
+		mTexture = mTextureHandle.get();
+
 	if (mMode == Show)
 		show();
 	else
@@ -766,9 +847,27 @@ MusicAction::~MusicAction()
 
 // ============================================================================
 
+bool MusicAction::isReady() const
+{
+	return mMusicHandle.isDone();
+}
+
+Uint32 MusicAction::prefetch()
+{
+	mMusicHandle.request();
+	return mMusicHandle.isValid() ? 1 : 0;
+}
+
 void MusicAction::setMusic(sf::Music* music)
 {
 	mMusic = music;
+	mMusicHandle = LoadHandle<sf::Music>();
+}
+
+void MusicAction::setMusic(const LoadHandle<sf::Music>& music)
+{
+	mMusic = 0;
+	mMusicHandle = music;
 }
 
 void MusicAction::setMode(Mode mode)
@@ -800,6 +899,16 @@ void MusicAction::setDuration(float duration)
 
 void MusicAction::run()
 {
+	if (mMusicHandle.isValid())
+		mMusic = mMusicHandle.get();
+
+	// Music isn't loaded in headless mode
+	if (!mMusic)
+	{
+		mIsComplete = true;
+		return;
+	}
+
 	if (mMode == Start)
 	{
 		if (mTransition == Transition::Fade)
@@ -883,9 +992,27 @@ SoundAction::~SoundAction()
 
 // ============================================================================
 
+bool SoundAction::isReady() const
+{
+	return mBufferHandle.isDone();
+}
+
+Uint32 SoundAction::prefetch()
+{
+	mBufferHandle.request();
+	return mBufferHandle.isValid() ? 1 : 0;
+}
+
 void SoundAction::setBuffer(sf::SoundBuffer* buffer)
 {
 	mBuffer = buffer;
+	mBufferHandle = LoadHandle<sf::SoundBuffer>();
+}
+
+void SoundAction::setBuffer(const LoadHandle<sf::SoundBuffer>& buffer)
+{
+	mBuffer = 0;
+	mBufferHandle = buffer;
 }
 
 void SoundAction::setVolume(float volume)
@@ -897,9 +1024,13 @@ void SoundAction::setVolume(float volume)
 
 void SoundAction::run()
 {
-	if (!mBuffer) return;
+	if (mBufferHandle.isValid())
+		mBuffer = mBufferHandle.get();
+
+	// Sound buffers aren't loaded in headless mode
+	if (mBuffer)
+		SoundMgr::playSound(mBuffer, mVolume);
 
-	SoundMgr::playSound(mBuffer, mVolume);
 	mIsComplete = true;
 }
 
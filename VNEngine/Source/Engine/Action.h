@@ -1,8 +1,12 @@
 #ifndef ACTION_H
 #define ACTION_H
 
+#include <Core/Condition.h>
+#include <Core/MemoryResource.h>
 #include <Core/Variant.h>
 
+#include <Engine/Resource.h>
+
 #include <SFML/Window.hpp>
 #include <SFML/Graphics.hpp>
 #include <SFML/Audio.hpp>
@@ -91,6 +95,13 @@ public:
 	/// <param name="cond">Function or lambda</param>
 	void setCondition(const std::function<bool()>& cond);
 
+	/// <summary>
+	/// Set the action's run condition to a compiled expression (see Scene::compileCondition).
+	/// This is used instead of the function condition, and the condition object has to stay alive as long as the action
+	/// </summary>
+	/// <param name="cond">Compiled condition</param>
+	void setCondition(const Condition* cond);
+
 	/// <summary>
 	/// Set the completion status of action
 	/// </summary>
@@ -109,6 +120,31 @@ public:
 	/// <returns>Condition met</returns>
 	bool isConditionMet() const;
 
+	/// <summary>
+	/// Returns true once everything the action needs is loaded.
+	/// An action that isn't ready waits without blocking the frame, and runs on the first update after it is ready
+	/// </summary>
+	/// <returns>Boolean</returns>
+	virtual bool isReady() const;
+
+	/// <summary>
+	/// Start loading the resources the action needs. Called by the scene's prefetcher before the action runs
+	/// </summary>
+	/// <returns>Number of resources the action uses, loaded or not</returns>
+	virtual Uint32 prefetch();
+
+	/// <summary>
+	/// Set if the action is waiting to run until it is ready
+	/// </summary>
+	/// <param name="waiting">Waiting flag</param>
+	void setWaiting(bool waiting);
+
+	/// <summary>
+	/// Returns true if the action is waiting to run until it is ready
+	/// </summary>
+	/// <returns>Boolean</returns>
+	bool isWaiting() const;
+
 protected:
 	/// <summary>
 	/// The scene the action should modify
@@ -120,10 +156,20 @@ protected:
 	/// </summary>
 	std::function<bool()> mCondition;
 
+	/// <summary>
+	/// The action's compiled run condition
+	/// </summary>
+	const Condition* mCompiledCondition;
+
 	/// <summary>
 	/// True if action has finished running
 	/// </summary>
 	bool mIsComplete;
+
+	/// <summary>
+	/// True if the action was started before it was ready
+	/// </summary>
+	bool mIsWaiting;
 };
 
 // ============================================================================
@@ -131,7 +177,7 @@ protected:
 class ActionGroup : public Action
 {
 public:
-	ActionGroup();
+	ActionGroup(MemoryResource* resource = getDefaultResource());
 	~ActionGroup();
 
 	/// <summary>
@@ -151,6 +197,13 @@ public:
 	/// <param name="e">Event</param>
 	void handleEvent(const sf::Event& e) override;
 
+	/// <summary>
+	/// Start loading the resources of all children actions.
+	/// The group itself uses no resources, children are counted when they run
+	/// </summary>
+	/// <returns>Zero</returns>
+	Uint32 prefetch() override;
+
 	/// <summary>
 	/// Add an action as a child of this group
 	/// </summary>
@@ -170,7 +223,7 @@ private:
 	/// <summary>
 	/// Children action
 	/// </summary>
-	std::vector<Action*> mActions;
+	ResourceVector<Action*> mActions;
 
 	/// <summary>
 	/// Index of the current action in execution
@@ -278,12 +331,31 @@ public:
 	/// </summary>
 	void run() override;
 
+	/// <summary>
+	/// Returns true once the background texture is loaded
+	/// </summary>
+	/// <returns>Boolean</returns>
+	bool isReady() const override;
+
+	/// <summary>
+	/// Start loading the background texture
+	/// </summary>
+	/// <returns>Number of resources used</returns>
+	Uint32 prefetch() override;
+
 	/// <summary>
 	/// Set the background texture. If NULL is passed as a value, the background will be hidden
 	/// </summary>
 	/// <param name="texture"></param>
 	void setTexture(sf::Texture* texture);
 
+	/// <summary>
+	/// Set the background texture to a resource that may still be loading.
+	/// The action waits for the load to finish before it runs
+	/// </summary>
+	/// <param name="texture">Texture load handle</param>
+	void setTexture(const LoadHandle<sf::Texture>& texture);
+
 	/// <summary>
 	/// Set the background transition effect
 	/// </summary>
@@ -308,6 +380,11 @@ private:
 	/// </summary>
 	sf::Texture* mTexture;
 
+	/// <summary>
+	/// Background texture that is loading
+	/// </summary>
+	LoadHandle<sf::Texture> mTextureHandle;
+
 	/// <summary>
 	/// The transition effect
 	/// </summary>
@@ -346,6 +423,18 @@ public:
 	/// </summary>
 	void run() override;
 
+	/// <summary>
+	/// Returns true once the texture is loaded
+	/// </summary>
+	/// <returns>Boolean</returns>
+	bool isReady() const override;
+
+	/// <summary>
+	/// Start loading the texture
+	/// </summary>
+	/// <returns>Number of resources used</returns>
+	Uint32 prefetch() override;
+
 	/// <summary>
 	/// Set image action mode (either show or hide image).
 	/// If the mode is "Hide" and the image is already hidden, nothing happens.
@@ -361,6 +450,13 @@ public:
 	/// <param name="texture">New texture</param>
 	void setTexture(sf::Texture* texture);
 
+	/// <summary>
+	/// Set the new texture to a resource that may still be loading.
+	/// The action waits for the load to finish before it runs
+	/// </summary>
+	/// <param name="texture">Texture load handle</param>
+	void setTexture(const LoadHandle<sf::Texture>& texture);
+
 	/// <summary>
 	/// Set the transition effect
 	/// </summary>
@@ -406,6 +502,11 @@ private:
 	/// </summary>
 	sf::Texture* mTexture;
 
+	/// <summary>
+	/// Texture that is loading
+	/// </summary>
+	LoadHandle<sf::Texture> mTextureHandle;
+
 	/// <summary>
 	/// Transition effect to use when switching
 	/// </summary>
@@ -530,12 +631,31 @@ public:
 	/// </summary>
 	void run() override;
 
+	/// <summary>
+	/// Returns true once the music is loaded
+	/// </summary>
+	/// <returns>Boolean</returns>
+	bool isReady() const override;
+
+	/// <summary>
+	/// Start loading the music
+	/// </summary>
+	/// <returns>Number of resources used</returns>
+	Uint32 prefetch() override;
+
 	/// <summary>
 	/// Set the music to start / stop
 	/// </summary>
 	/// <param name="music">Music</param>
 	void setMusic(sf::Music* music);
 
+	/// <summary>
+	/// Set the music to a resource that may still be loading.
+	/// The action waits for the load to finish before it runs
+	/// </summary>
+	/// <param name="music">Music load handle</param>
+	void setMusic(const LoadHandle<sf::Music>& music);
+
 	/// <summary>
 	/// Set music action mode to either start or stop the music
 	/// </summary>
@@ -581,6 +701,11 @@ private:
 	/// </summary>
 	sf::Music* mMusic;
 
+	/// <summary>
+	/// Music that is loading
+	/// </summary>
+	LoadHandle<sf::Music> mMusicHandle;
+
 	/// <summary>
 	/// Action mode (start or stop)
 	/// </summary>
@@ -620,12 +745,31 @@ public:
 	/// </summary>
 	void run() override;
 
+	/// <summary>
+	/// Returns true once the sound buffer is loaded
+	/// </summary>
+	/// <returns>Boolean</returns>
+	bool isReady() const override;
+
+	/// <summary>
+	/// Start loading the sound buffer
+	/// </summary>
+	/// <returns>Number of resources used</returns>
+	Uint32 prefetch() override;
+
 	/// <summary>
 	/// Set the sound buffer the sound should use
 	/// </summary>
 	/// <param name="buffer">Sound buffer object</param>
 	void setBuffer(sf::SoundBuffer* buffer);
 
+	/// <summary>
+	/// Set the sound buffer to a resource that may still be loading.
+	/// The action waits for the load to finish before it runs
+	/// </summary>
+	/// <param name="buffer">Sound buffer load handle</param>
+	void setBuffer(const LoadHandle<sf::SoundBuffer>& buffer);
+
 	/// <summary>
 	/// Set the volume the sound effect should be played at.
 	/// This value should be in the range 0 (mute) to 100 (full, default)
@@ -639,6 +783,11 @@ private:
 	/// </summary>
 	sf::SoundBuffer* mBuffer;
 
+	/// <summary>
+	/// Sound buffer that is loading
+	/// </summary>
+	LoadHandle<sf::SoundBuffer> mBufferHandle;
+
 	/// <summary>
 	/// Volume to play sound effect
 	/// </summary>
@@ -45,14 +45,17 @@ void Character::setName(const sf::String& name)
 	mName = name;
 }
 
-void Character::addImage(const sf::String& label, sf::Texture* image)
+void Character::addImage(NameId label, sf::Texture* image)
 {
-	mImages[label.toUtf32()] = image;
+	mImages[label] = image;
+	mImageResources.erase(label);
 }
 
-void Character::addImage(const sf::String& resName)
+void Character::addImage(NameId resName)
 {
-	addImage(resName, Resource<sf::Texture>::get(resName));
+	// Loading is left to the scene's prefetcher, or to getImage()
+	mImages.erase(resName);
+	mImageResources.insert(resName);
 }
 
 // ============================================================================
@@ -62,11 +65,15 @@ const sf::String& Character::getName() const
 	return mName;
 }
 
-sf::Texture* Character::getImage(const sf::String& label) const
+sf::Texture* Character::getImage(NameId label) const
 {
-	auto it = mImages.find(label.toUtf32());
+	auto it = mImages.find(label);
 	if (it != mImages.end())
 		return it->second;
+
+	if (mImageResources.count(label))
+		return Resource<sf::Texture>::get(label);
+
 	return 0;
 }
 
@@ -103,13 +110,16 @@ void Character::think(const sf::String& dialogue)
 	addAction(action);
 }
 
-void Character::show(const sf::String& image, Transition effect, float duration)
+void Character::show(NameId image, Transition effect, float duration)
 {
 	if (!mScene) return;
 
 	ImageAction* action = mScene->alloc<ImageAction>();
 	action->setMode(ImageAction::Show);
-	action->setTexture(mImages[image.toUtf32()]);
+	if (mImageResources.count(image))
+		action->setTexture(LoadHandle<sf::Texture>(image));
+	else
+		action->setTexture(mImages[image]);
 	action->setTransition(effect);
 	action->setDuration(duration);
 	action->setImageBox(mImageBox);
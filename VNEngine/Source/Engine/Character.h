@@ -5,10 +5,12 @@
 #include <SFML/Graphics.hpp>
 
 #include <Core/DataTypes.h>
+#include <Core/NameId.h>
 
 #include <Engine/Action.h>
 
 #include <unordered_map>
+#include <unordered_set>
 
 namespace vne
 {
@@ -48,17 +50,17 @@ public:
 	/// </summary>
 	/// <param name="label">Image label</param>
 	/// <param name="image">Pointer to the image texture</param>
-	void addImage(const sf::String& label, sf::Texture* image);
+	void addImage(NameId label, sf::Texture* image);
 
 	/// <summary>
-	/// Add a character image by resource name. The texture will be loaded from the resource system and
-	/// the image will be given a label that will be the same as its resource name.
+	/// Add a character image by resource name. The texture will be loaded from the resource system when it is first shown,
+	/// and the image will be given a label that will be the same as its resource name.
 	/// These images can include a subsection of the entire character that gets reused for several different poses.
 	/// Ex: "happy" - has a happy image of the character,
 	/// "hand_up_r" - an image of just the character's right hand up in the air.
 	/// </summary>
 	/// <param name="resName">Name of the texture as it was assigned in the resource system</param>
-	void addImage(const sf::String& resName);
+	void addImage(NameId resName);
 
 	/// <summary>
 	/// Get the characters name
@@ -71,7 +73,7 @@ public:
 	/// </summary>
 	/// <param name="label">Label of image to retrieve</param>
 	/// <returns>Pointer to image texture</returns>
-	sf::Texture* getImage(const sf::String& label) const;
+	sf::Texture* getImage(NameId label) const;
 
 	/// <summary>
 	/// Get the image box that is used to display image boxes
@@ -100,7 +102,7 @@ public:
 	/// <param name="image">Name of the character image</param>
 	/// <param name="effect">Transition effect</param>
 	/// <param name="duration">Duration of the transition effect</param>
-	void show(const sf::String& image, Transition effect = Transition::None, float duration = 1.0f);
+	void show(NameId image, Transition effect = Transition::None, float duration = 1.0f);
 
 	/// <summary>
 	/// Hide the current character image with a transition effect
@@ -160,7 +162,12 @@ private:
 	/// <summary>
 	/// Map of character images
 	/// </summary>
-	std::unordered_map<std::basic_string<Uint32>, sf::Texture*> mImages;
+	std::unordered_map<NameId, sf::Texture*> mImages;
+
+	/// <summary>
+	/// Images added by resource name, the name is also the image label
+	/// </summary>
+	std::unordered_set<NameId> mImageResources;
 
 	/// <summary>
 	/// UI element used to display character
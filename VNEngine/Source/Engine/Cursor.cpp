@@ -3,7 +3,7 @@
 using namespace vne;
 
 sf::Window* Cursor::mWindow = 0;
-sf::Cursor Cursor::mCursors[13];
+sf::Cursor* Cursor::mCursors = 0;
 
 // ============================================================================
 
@@ -11,6 +11,9 @@ void Cursor::init(sf::Window* window)
 {
 	mWindow = window;
 
+	if (!mCursors)
+		mCursors = new sf::Cursor[13];
+
 	for (int i = 0; i < 13; ++i)
 		mCursors[i].loadFromSystem((sf::Cursor::Type)i);
 }
@@ -19,6 +22,8 @@ void Cursor::init(sf::Window* window)
 
 void Cursor::setCursor(sf::Cursor::Type type)
 {
+	if (!mWindow) return;
+
 	mWindow->setMouseCursor(mCursors[type]);
 }
 
@@ -11,6 +11,11 @@ namespace vne
 class Cursor
 {
 public:
+	/// <summary>
+	/// Load system cursors for a window.
+	/// Until this is called setting the cursor does nothing
+	/// </summary>
+	/// <param name="window">Main window</param>
 	static void init(sf::Window* window);
 
 	/// <summary>
@@ -21,7 +26,10 @@ public:
 
 private:
 	static sf::Window* mWindow;
-	static sf::Cursor mCursors[13];
+	/// <summary>
+	/// System cursors, created in init() since they need a display
+	/// </summary>
+	static sf::Cursor* mCursors;
 };
 
 // ============================================================================
@@ -1,31 +1,89 @@
 #include <Engine/Engine.h>
 #include <Engine/Scene.h>
 #include <Engine/Resource.h>
+#include <Engine/ResourceLoader.h>
 #include <Engine/Cursor.h>
 
+#include <Core/FrameProfiler.h>
+#include <Core/PoolStats.h>
+
+#ifdef VNE_POOL_STATS
+#include <fstream>
+#endif
+
 using namespace vne;
 
+// ============================================================================
+
+namespace
+{
+/* Max time spent finishing background loads each frame, in seconds */
+const float gLoadBudget = 0.004f;
+}
+
 // ============================================================================
 // ============================================================================
 
 Engine::Engine() :
+	mWindow			(0),
+	mIsClosed		(false),
 	mSetupScene		(0),
 	mScene			(0),
 	mNextScene		(0),
-	mView			(sf::FloatRect(0.0f, 0.0f, 1920.0f, 1080.0f))
+	mView			(sf::FloatRect(0.0f, 0.0f, 1920.0f, 1080.0f)),
+	mFont			(0),
+	mShowProfileGraph	(false)
 {
 
 }
 
 Engine::~Engine()
 {
+	ResourceLoader::stop();
 
+	delete mWindow;
 }
 
 // ============================================================================
 // ============================================================================
 
 bool Engine::init(const EngineParams& params)
+{
+	setHeadless(params.mHeadless);
+
+	if (params.mHeadless)
+	{
+		// Render to a target the size of the window, without creating a context
+		mNullTarget.create(params.mWindowWidth, params.mWindowHeight);
+		mNullTarget.setView(mView);
+	}
+	else
+		initWindow(params);
+
+	mShowProfileGraph = params.mShowProfileGraph;
+
+	// Start background loading before the setup scene adds resources
+	ResourceLoader::start(params.mNumLoaderThreads);
+
+
+	// Load recorded pool usage
+	mPoolProfilePath = params.mPoolProfile;
+	if (!mPoolProfilePath.empty())
+		mPoolProfile.load(mPoolProfilePath);
+
+
+	// Setup scene
+	mSetupScene = params.mSetupScene;
+	if (!mSetupScene) return false;
+	mSetupScene->init();
+
+	// Make sure the setup scene set a default font
+	if (!mFont) return false;
+
+	return true;
+}
+
+void Engine::initWindow(const EngineParams& params)
 {
 	// Set window style based on params
 	sf::Uint32 style = sf::Style::Default;
@@ -49,31 +107,20 @@ bool Engine::init(const EngineParams& params)
 	settings.stencilBits = 8;
 
 	// Create window
-	mWindow.create(
+	mWindow = new sf::RenderWindow(
 		vmode,
 		params.mWindowTitle,
 		style,
 		settings
 	);
 	// Enable v-sync
-	mWindow.setVerticalSyncEnabled(true);
+	mWindow->setVerticalSyncEnabled(true);
 
 	// Main view
-	mWindow.setView(mView);
+	mWindow->setView(mView);
 
 	// Initialize cursors
-	Cursor::init(&mWindow);
-
-
-	// Setup scene
-	mSetupScene = params.mSetupScene;
-	if (!mSetupScene) return false;
-	mSetupScene->init();
-
-	// Make sure the setup scene set a default font
-	if (!mFont) return false;
-
-	return true;
+	Cursor::init(mWindow);
 }
 
 // ============================================================================
@@ -81,6 +128,26 @@ bool Engine::init(const EngineParams& params)
 
 void Engine::switchScenes()
 {
+	PROFILE_SCOPE(SceneSwitch);
+
+#ifdef VNE_POOL_STATS
+	// Dump pool usage while the old scene still has everything allocated
+	if (mScene)
+	{
+		std::string name = getSceneName(mScene);
+
+		std::ofstream file("PoolStats.json", std::ios::app);
+		PoolStatsRegistry::dumpJson(file, name.c_str());
+
+		// Record peak counts for the next run
+		if (!mPoolProfilePath.empty())
+		{
+			mScene->recordPoolUsage(mPoolProfile, name);
+			mPoolProfile.save(mPoolProfilePath);
+		}
+	}
+#endif
+
 	// Cleanup old scene
 	if (mScene)
 		mScene->cleanup();
@@ -92,14 +159,29 @@ void Engine::switchScenes()
 	for (auto it = mCharacters.begin(); it != mCharacters.end(); ++it)
 		it->second.setScene(mScene);
 
+	// Reserve pool pages before the new scene starts allocating
+	if (!mPoolProfilePath.empty())
+		mScene->prewarmPools(mPoolProfile.getCounts(getSceneName(mScene)));
+
 	// Initialize new scene
 	mScene->init();
 }
 
+std::string Engine::getSceneName(Scene* scene) const
+{
+	for (auto it = mScenes.begin(); it != mScenes.end(); ++it)
+	{
+		if (it->second == scene)
+			return it->first.getString().toAnsiString();
+	}
+
+	return std::string();
+}
+
 void Engine::run()
 {
 	// Set next scene to current scene, and reset
-	switchScenes();
+	start();
 
 
 	// Poll events once before starting
@@ -108,8 +190,10 @@ void Engine::run()
 	sf::Clock clock;
 
 	// Game loop
-	while (mWindow.isOpen())
+	while (isOpen())
 	{
+		PROFILE_FRAME();
+
 		// If scene switch is requested, then switch scenes
 		if (mNextScene)
 			switchScenes();
@@ -124,6 +208,9 @@ void Engine::run()
 		render();
 	}
 
+	// Stop loading before the resources are freed
+	ResourceLoader::stop();
+
 	// Free all SFML resources
 	Resource<sf::Texture>::free();
 	Resource<sf::Font>::free();
@@ -131,56 +218,96 @@ void Engine::run()
 	Resource<sf::Music>::free();
 }
 
+void Engine::start()
+{
+	switchScenes();
+}
+
+void Engine::step(float dt, const sf::Event* events, Uint32 numEvents)
+{
+	PROFILE_FRAME();
+
+	// If scene switch is requested, then switch scenes
+	if (mNextScene)
+		switchScenes();
+
+	// Handle input
+	{
+		PROFILE_SCOPE(Events);
+		for (Uint32 i = 0; i < numEvents; ++i)
+			handleEvent(events[i]);
+	}
+
+	update(dt);
+	render();
+}
+
 // ============================================================================
 
 void Engine::pollEvents()
 {
+	if (!mWindow) return;
+
+	PROFILE_SCOPE(Events);
+
 	sf::Event e;
 
-	while (mWindow.pollEvent(e))
+	while (mWindow->pollEvent(e))
+		handleEvent(e);
+}
+
+void Engine::handleEvent(const sf::Event& e)
+{
+	// Handle window close
+	if (e.type == sf::Event::Closed)
+		close();
+
+	// Handle window resize
+	else if (e.type == sf::Event::Resized)
 	{
-		// Handle window close
-		if (e.type == sf::Event::Closed)
-			mWindow.close();
+		float ARs = (float)e.size.width / e.size.height;
+		const sf::Vector2f& viewSize = mView.getSize();
+		float ARc = viewSize.x / viewSize.y;
 
-		// Handle window resize
-		else if (e.type == sf::Event::Resized)
+		float w, h, x, y;
+		if (ARs >= ARc)
 		{
-			float ARs = (float)e.size.width / e.size.height;
-			const sf::Vector2f& viewSize = mView.getSize();
-			float ARc = viewSize.x / viewSize.y;
-
-			float w, h, x, y;
-			if (ARs >= ARc)
-			{
-				// Width is relatively bigger
-				w = ARc / ARs;
-				h = 1.0f;
-				x = (1.0f - w) * 0.5f;
-				y = 0.0f;
-			}
-			else
-			{
-				// Height is relatively bigger
-				w = 1.0f;
-				h = ARs / ARc;
-				x = 0.0f;
-				y = (1.0f - h) * 0.5f;
-			}
-
-			// Apply view
-			mView.setViewport(sf::FloatRect(x, y, w, h));
-			mWindow.setView(mView);
+			// Width is relatively bigger
+			w = ARc / ARs;
+			h = 1.0f;
+			x = (1.0f - w) * 0.5f;
+			y = 0.0f;
 		}
+		else
+		{
+			// Height is relatively bigger
+			w = 1.0f;
+			h = ARs / ARc;
+			x = 0.0f;
+			y = (1.0f - h) * 0.5f;
+		}
+
+		// The null target has no window to resize it
+		if (!mWindow)
+			mNullTarget.create(e.size.width, e.size.height);
 
-		mScene->handleEvent(e);
+		// Apply view
+		mView.setViewport(sf::FloatRect(x, y, w, h));
+		getRenderTarget().setView(mView);
 	}
+
+	mScene->handleEvent(e);
 }
 
 // ============================================================================
 
 void Engine::update(float dt)
 {
+	PROFILE_SCOPE(Update);
+
+	// Create resources that finished loading in the background
+	ResourceLoader::update(gLoadBudget);
+
 	mScene->update(dt);
 }
 
@@ -188,26 +315,60 @@ void Engine::update(float dt)
 
 void Engine::render()
 {
-	// Clear screen
-	mWindow.clear();
+	sf::RenderTarget& target = getRenderTarget();
+
+	{
+		PROFILE_SCOPE(Render);
 
-	// Render stuff
-	mScene->render();
+		// Clear screen
+		target.clear();
+
+		// Render stuff
+		mScene->render();
+
+		// Frame time graph goes over everything
+		if (mShowProfileGraph)
+			target.draw(mProfileGraph);
+	}
 
 	// Swap buffers
-	mWindow.display();
+	if (mWindow)
+	{
+		PROFILE_SCOPE(Display);
+		mWindow->display();
+	}
 }
 
 // ============================================================================
 
 void Engine::close()
 {
-	mWindow.close();
+	mIsClosed = true;
+
+	if (mWindow)
+		mWindow->close();
+}
+
+bool Engine::isOpen() const
+{
+	return mWindow ? mWindow->isOpen() : !mIsClosed;
 }
 
 // ============================================================================
 // ============================================================================
 
+void Engine::setProfileGraphVisible(bool visible)
+{
+	mShowProfileGraph = visible;
+}
+
+bool Engine::isProfileGraphVisible() const
+{
+	return mShowProfileGraph;
+}
+
+// ============================================================================
+
 void Engine::setDefaultFont(sf::Font* font)
 {
 	mFont = font;
@@ -223,40 +384,45 @@ sf::Font* Engine::getDefaultFont() const
 
 void Engine::addCharacter(const Character& character)
 {
-	mCharacters[character.getName().toUtf32()] = character;
+	mCharacters[character.getName()] = character;
 }
 
-Character& Engine::getCharacter(const sf::String& name)
+Character& Engine::getCharacter(NameId name)
 {
-	return mCharacters[name.toUtf32()];
+	return mCharacters[name];
 }
 
-bool Engine::variableExists(const sf::String& name) const
+bool Engine::variableExists(NameId name) const
 {
-	return mVariables.find(name.toUtf32()) != mVariables.end();
+	return mVariables.exists(name);
 }
 
-void Engine::addScene(const sf::String& name, Scene* scene)
+VariableStore& Engine::getVariables()
 {
-	mScenes[name.toUtf32()] = scene;
+	return mVariables;
 }
 
-Scene* Engine::getScene(const sf::String& name) const
+void Engine::addScene(NameId name, Scene* scene)
 {
-	auto it = mScenes.find(name.toUtf32());
+	mScenes[name] = scene;
+}
+
+Scene* Engine::getScene(NameId name) const
+{
+	auto it = mScenes.find(name);
 	if (it != mScenes.end())
 		return it->second;
 	return 0;
 }
 
-void Engine::gotoScene(const sf::String& name)
+void Engine::gotoScene(NameId name)
 {
 	Scene* scene = getScene(name);
 	if (scene)
 		mNextScene = scene;
 }
 
-std::unordered_map<std::basic_string<Uint32>, Scene*>& Engine::getSceneMap()
+std::unordered_map<NameId, Scene*>& Engine::getSceneMap()
 {
 	return mScenes;
 }
@@ -265,7 +431,29 @@ std::unordered_map<std::basic_string<Uint32>, Scene*>& Engine::getSceneMap()
 
 sf::RenderWindow& Engine::getWindow()
 {
-	return mWindow;
+	return *mWindow;
+}
+
+sf::RenderTarget& Engine::getRenderTarget()
+{
+	if (mWindow)
+		return *mWindow;
+	return mNullTarget;
+}
+
+const sf::View& Engine::getView() const
+{
+	return mView;
+}
+
+sf::Vector2f Engine::mapPixelToCoords(const sf::Vector2i& pixel)
+{
+	return getRenderTarget().mapPixelToCoords(pixel);
+}
+
+Scene* Engine::getCurrentScene() const
+{
+	return mScene;
 }
 
 // ============================================================================
@@ -277,7 +465,10 @@ EngineParams::EngineParams() :
 	mWindowTitle		("VN Game"),
 	mFullscreen			(false),
 	mResizable			(true),
-	mSetupScene			(0)
+	mSetupScene			(0),
+	mHeadless			(false),
+	mNumLoaderThreads	(2),
+	mShowProfileGraph	(false)
 {
 
 }
@@ -2,13 +2,18 @@
 #define ENGINE_H
 
 #include <Core/DataTypes.h>
+#include <Core/NameId.h>
+#include <Core/PoolProfile.h>
 #include <Core/Variant.h>
+#include <Core/VariableStore.h>
 
 #include <SFML/System.hpp>
 #include <SFML/Graphics.hpp>
 
 #include <Engine/Scene.h>
 #include <Engine/Character.h>
+#include <Engine/NullRenderTarget.h>
+#include <Engine/ProfileGraph.h>
 
 namespace vne
 {
@@ -59,6 +64,32 @@ struct EngineParams
 	/// Use this to specify the setup scene.
 	/// </summary>
 	SetupScene* mSetupScene;
+
+	/// <summary>
+	/// Path of the pool profile file. If set, scenes reserve pool pages based on the peak object
+	/// counts stored in this file. Builds with pool stats enabled record new peaks to it.
+	/// Leave empty to disable
+	/// </summary>
+	std::string mPoolProfile;
+
+	/// <summary>
+	/// If true, the engine runs without a window, GPU, or audio device (i.e. for tests and benchmarks).
+	/// Scenes render to a null target the size of the window, textures and audio are not loaded,
+	/// and text uses estimated glyph metrics. The game is driven with step() instead of run()
+	/// </summary>
+	bool mHeadless;
+
+	/// <summary>
+	/// Number of worker threads used to load resources in the background.
+	/// Set to 0 to load every resource on the main thread when it is first used
+	/// </summary>
+	Uint32 mNumLoaderThreads;
+
+	/// <summary>
+	/// If true, a graph of recent frame times is drawn over the game.
+	/// The graph is empty unless the engine is built with VNE_PROFILER
+	/// </summary>
+	bool mShowProfileGraph;
 };
 
 // ============================================================================
@@ -91,6 +122,32 @@ public:
 	/// </summary>
 	void close();
 
+	/// <summary>
+	/// Returns true until the engine is closed
+	/// </summary>
+	/// <returns>Boolean</returns>
+	bool isOpen() const;
+
+	/// <summary>
+	/// Switch to the first scene.
+	/// Only needed when driving the engine with step() instead of run()
+	/// </summary>
+	void start();
+
+	/// <summary>
+	/// Run a single frame with the given time step and input events, instead of polling the window
+	/// </summary>
+	/// <param name="dt">Time step (in seconds)</param>
+	/// <param name="events">Events to handle this frame</param>
+	/// <param name="numEvents">Number of events</param>
+	void step(float dt, const sf::Event* events = 0, Uint32 numEvents = 0);
+
+	/// <summary>
+	/// Handle an input event as if it came from the window
+	/// </summary>
+	/// <param name="e">Event</param>
+	void handleEvent(const sf::Event& e);
+
 
 	/// <summary>
 	/// Set the coordinate space dimensions.
@@ -104,6 +161,18 @@ public:
 	/// <param name="h">Height of the coordinate space</param>
 	void setViewSize(Uint32 w, Uint32 h);
 
+	/// <summary>
+	/// Show or hide the frame time graph
+	/// </summary>
+	/// <param name="visible">Visibility</param>
+	void setProfileGraphVisible(bool visible);
+
+	/// <summary>
+	/// Returns true if the frame time graph is shown
+	/// </summary>
+	/// <returns>Boolean</returns>
+	bool isProfileGraphVisible() const;
+
 	/// <summary>
 	/// Set the default font for the engine
 	/// </summary>
@@ -128,7 +197,7 @@ public:
 	/// </summary>
 	/// <param name="name">Name of character</param>
 	/// <returns>Character object</returns>
-	Character& getCharacter(const sf::String& name);
+	Character& getCharacter(NameId name);
 
 	/// <summary>
 	/// Set a global game variable (i.e. to keep track of affection points)
@@ -136,9 +205,9 @@ public:
 	/// <param name="name">Name of the variable</param>
 	/// <param name="val">Value of the variable</param>
 	template <typename T>
-	void setVariable(const sf::String& name, const T& val)
+	void setVariable(NameId name, const T& val)
 	{
-		mVariables[name.toUtf32()] = val;
+		mVariables.set(mVariables.add(name), Variant(val));
 	}
 
 	/// <summary>
@@ -147,55 +216,105 @@ public:
 	/// <param name="name">Name of the variable to retrieve</param>
 	/// <returns>Reference to the variable</returns>
 	template <typename T>
-	T getVariable(const sf::String& name) const
+	T getVariable(NameId name) const
 	{
-		auto it = mVariables.find(name.toUtf32());
-		if (it != mVariables.end())
-			return it->second;
+		Uint32 slot = mVariables.getSlot(name);
+		if (slot != VariableStore::InvalidSlot)
+			return mVariables.get(slot).get<T>();
 		return T();
 	}
 
+	/// <summary>
+	/// Get a typed handle to a game variable, creating the variable if it doesn't exist.
+	/// Reading and writing through the handle skips the name lookup
+	/// </summary>
+	/// <param name="name">Name of the variable</param>
+	/// <returns>Variable handle</returns>
+	template <typename T>
+	VariableHandle<T> getVariableHandle(NameId name)
+	{
+		return mVariables.getHandle<T>(name);
+	}
+
 	/// <summary>
 	/// Returns true if variable exists or has been created
 	/// </summary>
 	/// <param name="name">Name of the variable</param>
 	/// <returns>Boolean</returns>
-	bool variableExists(const sf::String& name) const;
+	bool variableExists(NameId name) const;
+
+	/// <summary>
+	/// Get the store that holds all game variables (i.e. to save the variables that changed)
+	/// </summary>
+	/// <returns>Variable store</returns>
+	VariableStore& getVariables();
 
 	/// <summary>
 	/// Add a scene to the engine
 	/// </summary>
 	/// <param name="name">Name of scene</param>
 	/// <param name="scene">Pointer to scene</param>
-	void addScene(const sf::String& name, Scene* scene);
+	void addScene(NameId name, Scene* scene);
 
 	/// <summary>
 	/// Gets pointer to scene
 	/// </summary>
 	/// <param name="name">Name of scene</param>
 	/// <returns>Pointer to scene</returns>
-	Scene* getScene(const sf::String& name) const;
+	Scene* getScene(NameId name) const;
 
 	/// <summary>
 	/// Switches current scene
 	/// </summary>
 	/// <param name="name">Name of scene to switch to</param>
-	void gotoScene(const sf::String& name);
+	void gotoScene(NameId name);
 
 	/// <summary>
 	/// Get unordered map of scenes, scene name is mapped to scene pointer
 	/// </summary>
 	/// <returns>The map of scenes</returns>
-	std::unordered_map<std::basic_string<Uint32>, Scene*>& getSceneMap();
+	std::unordered_map<NameId, Scene*>& getSceneMap();
 
 
 	/// <summary>
-	/// Get main game window
+	/// Get main game window.
+	/// There is no window in headless mode, so use getRenderTarget() or getView() where possible
 	/// </summary>
 	/// <returns>SFML window</returns>
 	sf::RenderWindow& getWindow();
 
+	/// <summary>
+	/// Get the target scenes render to, the window or the null target in headless mode
+	/// </summary>
+	/// <returns>Render target</returns>
+	sf::RenderTarget& getRenderTarget();
+
+	/// <summary>
+	/// Get the main view
+	/// </summary>
+	/// <returns>View</returns>
+	const sf::View& getView() const;
+
+	/// <summary>
+	/// Convert a window pixel position to coordinate space
+	/// </summary>
+	/// <param name="pixel">Pixel position</param>
+	/// <returns>Position in coordinate space</returns>
+	sf::Vector2f mapPixelToCoords(const sf::Vector2i& pixel);
+
+	/// <summary>
+	/// Get the current scene
+	/// </summary>
+	/// <returns>Current scene</returns>
+	Scene* getCurrentScene() const;
+
 private:
+	/// <summary>
+	/// Create the game window and cursors
+	/// </summary>
+	/// <param name="params">Engine parameters</param>
+	void initWindow(const EngineParams& params);
+
 	/// <summary>
 	/// Handles all input events from the window
 	/// </summary>
@@ -217,11 +336,28 @@ private:
 	/// </summary>
 	void switchScenes();
 
+	/// <summary>
+	/// Get the name a scene was added with
+	/// </summary>
+	/// <param name="scene">Pointer to scene</param>
+	/// <returns>Scene name, or an empty string if the scene wasn't added</returns>
+	std::string getSceneName(Scene* scene) const;
+
 private:
 	/// <summary>
-	/// Main game window.
+	/// Main game window. Null in headless mode
+	/// </summary>
+	sf::RenderWindow* mWindow;
+
+	/// <summary>
+	/// Render target used in headless mode
+	/// </summary>
+	NullRenderTarget mNullTarget;
+
+	/// <summary>
+	/// Set when a headless engine is closed
 	/// </summary>
-	sf::RenderWindow mWindow;
+	bool mIsClosed;
 
 	/// <summary>
 	/// The very first scene that is called, it sets up all resources,
@@ -249,20 +385,40 @@ private:
 	/// </summary>
 	sf::Font* mFont;
 
+	/// <summary>
+	/// Frame time graph
+	/// </summary>
+	ProfileGraph mProfileGraph;
+
+	/// <summary>
+	/// Set if the frame time graph is drawn
+	/// </summary>
+	bool mShowProfileGraph;
+
 	/// <summary>
 	/// Map of game characters
 	/// </summary>
-	std::unordered_map<std::basic_string<Uint32>, Character> mCharacters;
+	std::unordered_map<NameId, Character> mCharacters;
 
 	/// <summary>
-	/// Map of global game variables
+	/// Global game variables
 	/// </summary>
-	std::unordered_map<std::basic_string<Uint32>, Variant> mVariables;
+	VariableStore mVariables;
 
 	/// <summary>
 	/// Map of game scenes
 	/// </summary>
-	std::unordered_map<std::basic_string<Uint32>, Scene*> mScenes;
+	std::unordered_map<NameId, Scene*> mScenes;
+
+	/// <summary>
+	/// Path of the pool profile file
+	/// </summary>
+	std::string mPoolProfilePath;
+
+	/// <summary>
+	/// Peak pool object counts of each scene
+	/// </summary>
+	PoolProfile mPoolProfile;
 };
 
 // ============================================================================
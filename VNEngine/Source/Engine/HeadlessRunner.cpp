@@ -0,0 +1,211 @@
+#include <Engine/HeadlessRunner.h>
+#include <Engine/Engine.h>
+
+#include <Core/PoolStats.h>
+
+#include <algorithm>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+using namespace vne;
+
+// ============================================================================
+// ============================================================================
+
+namespace
+{
+/* Sum of the actions run by every scene */
+Uint64 getNumActionsRun(Engine* engine)
+{
+	Uint64 count = 0;
+
+	std::unordered_map<NameId, Scene*>& scenes = engine->getSceneMap();
+	for (auto it = scenes.begin(); it != scenes.end(); ++it)
+		count += it->second->getNumActionsRun();
+
+	return count;
+}
+}
+
+// ============================================================================
+// ============================================================================
+
+HeadlessStats::HeadlessStats() :
+	mNumFrames		(0),
+	mSimTime		(0.0),
+	mWallTime		(0.0),
+	mNumActions		(0),
+	mNumEvents		(0),
+	mNumAllocs		(0),
+	mNumPageAllocs	(0),
+	mPeakMemory		(0),
+	mFinished		(false)
+{
+
+}
+
+double HeadlessStats::getActionsPerSecond() const
+{
+	return mWallTime > 0.0 ? mNumActions / mWallTime : 0.0;
+}
+
+// ============================================================================
+// ============================================================================
+
+HeadlessRunner::HeadlessRunner(Engine* engine) :
+	mEngine			(engine),
+	mFrameTime		(1.0f / 60.0f)
+{
+
+}
+
+// ============================================================================
+
+void HeadlessRunner::setFrameTime(float dt)
+{
+	mFrameTime = dt;
+}
+
+void HeadlessRunner::addEvent(float time, const sf::Event& e)
+{
+	ScriptEvent event;
+	event.mTime = time;
+	event.mEvent = e;
+	mEvents.push_back(event);
+}
+
+void HeadlessRunner::addClick(float time, const sf::Vector2i& pos)
+{
+	sf::Event e;
+	e.type = sf::Event::MouseButtonPressed;
+	e.mouseButton.button = sf::Mouse::Left;
+	e.mouseButton.x = pos.x;
+	e.mouseButton.y = pos.y;
+	addEvent(time, e);
+
+	e.type = sf::Event::MouseButtonReleased;
+	addEvent(time, e);
+}
+
+void HeadlessRunner::addClicks(float start, float interval, Uint32 count, const sf::Vector2i& pos)
+{
+	for (Uint32 i = 0; i < count; ++i)
+		addClick(start + i * interval, pos);
+}
+
+void HeadlessRunner::addKeyPress(float time, sf::Keyboard::Key key)
+{
+	sf::Event e;
+	e.type = sf::Event::KeyPressed;
+	e.key.code = key;
+	e.key.alt = false;
+	e.key.control = false;
+	e.key.shift = false;
+	e.key.system = false;
+	addEvent(time, e);
+
+	e.type = sf::Event::KeyReleased;
+	addEvent(time, e);
+}
+
+void HeadlessRunner::clearEvents()
+{
+	mEvents.clear();
+}
+
+// ============================================================================
+
+HeadlessStats HeadlessRunner::run(float maxTime)
+{
+	HeadlessStats stats;
+
+	// Send events in time order, events at the same time keep the order they were added in
+	std::stable_sort(mEvents.begin(), mEvents.end(),
+		[](const ScriptEvent& a, const ScriptEvent& b) { return a.mTime < b.mTime; });
+
+	std::vector<sf::Event> frameEvents;
+	Uint32 nextEvent = 0;
+	Uint32 numFinishedFrames = 0;
+
+#ifdef VNE_POOL_STATS
+	PoolStats startPools = PoolStatsRegistry::getTotals();
+#endif
+
+	sf::Clock clock;
+
+	mEngine->start();
+	Uint64 startActions = getNumActionsRun(mEngine);
+
+	while (mEngine->isOpen() && stats.mSimTime < maxTime)
+	{
+		// Gather the events that are due this frame
+		frameEvents.clear();
+		for (; nextEvent < mEvents.size() && mEvents[nextEvent].mTime <= stats.mSimTime; ++nextEvent)
+			frameEvents.push_back(mEvents[nextEvent].mEvent);
+
+		mEngine->step(mFrameTime, frameEvents.data(), (Uint32)frameEvents.size());
+
+		stats.mSimTime += mFrameTime;
+		stats.mNumEvents += (Uint32)frameEvents.size();
+		++stats.mNumFrames;
+
+		// The script is done once the scene stays finished for a whole frame, since a scene switch happens on the next step
+		if (nextEvent == mEvents.size() && mEngine->getCurrentScene()->isFinished())
+		{
+			if (++numFinishedFrames > 1)
+				break;
+		}
+		else
+			numFinishedFrames = 0;
+	}
+
+	stats.mWallTime = clock.getElapsedTime().asMicroseconds() * 1.0e-6;
+	stats.mNumActions = getNumActionsRun(mEngine) - startActions;
+	stats.mFinished = !mEngine->isOpen() || numFinishedFrames > 1;
+	stats.mPeakMemory = getPeakMemory();
+
+#ifdef VNE_POOL_STATS
+	PoolStats endPools = PoolStatsRegistry::getTotals();
+	stats.mNumAllocs = endPools.mNumCreates - startPools.mNumCreates;
+	stats.mNumPageAllocs = endPools.mNumPageAllocs - startPools.mNumPageAllocs;
+#endif
+
+	return stats;
+}
+
+// ============================================================================
+
+Uint64 HeadlessRunner::getPeakMemory()
+{
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS counters;
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+		return counters.PeakWorkingSetSize;
+	return 0;
+#else
+	rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0)
+		return 0;
+
+#ifdef __APPLE__
+	// Bytes on macOS
+	return (Uint64)usage.ru_maxrss;
+#else
+	// Kilobytes on Linux
+	return (Uint64)usage.ru_maxrss * 1024;
+#endif
+#endif
+}
+
+// ============================================================================
@@ -0,0 +1,172 @@
+#ifndef HEADLESS_RUNNER_H
+#define HEADLESS_RUNNER_H
+
+#include <Core/DataTypes.h>
+
+#include <SFML/Window.hpp>
+
+#include <vector>
+
+namespace vne
+{
+
+// ============================================================================
+
+class Engine;
+
+/// <summary>
+/// Results of a headless run
+/// </summary>
+struct HeadlessStats
+{
+	HeadlessStats();
+
+	/// <summary>
+	/// Number of frames stepped
+	/// </summary>
+	Uint32 mNumFrames;
+
+	/// <summary>
+	/// Simulated time in seconds
+	/// </summary>
+	double mSimTime;
+
+	/// <summary>
+	/// Real time the run took in seconds
+	/// </summary>
+	double mWallTime;
+
+	/// <summary>
+	/// Number of scene actions that ran
+	/// </summary>
+	Uint64 mNumActions;
+
+	/// <summary>
+	/// Number of input events sent
+	/// </summary>
+	Uint32 mNumEvents;
+
+	/// <summary>
+	/// Number of objects created from object pools during the run. Only counted if pool stats are enabled
+	/// </summary>
+	Uint64 mNumAllocs;
+
+	/// <summary>
+	/// Number of pool pages allocated during the run. Only counted if pool stats are enabled
+	/// </summary>
+	Uint64 mNumPageAllocs;
+
+	/// <summary>
+	/// Peak resident memory of the process in bytes, or 0 if it isn't available
+	/// </summary>
+	Uint64 mPeakMemory;
+
+	/// <summary>
+	/// True if the run stopped because the engine was closed or the script finished, instead of the time limit
+	/// </summary>
+	bool mFinished;
+
+	/// <summary>
+	/// Get the number of actions run per real second
+	/// </summary>
+	/// <returns>Actions per second</returns>
+	double getActionsPerSecond() const;
+};
+
+// ============================================================================
+
+/// <summary>
+/// Drives a headless engine with a fixed time step and a script of input events,
+/// so whole games can run without a display (i.e. for CI, throughput benchmarks, and soak tests).
+/// The engine must be initialized with EngineParams::mHeadless set
+/// </summary>
+class HeadlessRunner
+{
+public:
+	HeadlessRunner(Engine* engine);
+
+	/// <summary>
+	/// Set the simulated time of each frame. The default is 1/60 of a second
+	/// </summary>
+	/// <param name="dt">Frame time in seconds</param>
+	void setFrameTime(float dt);
+
+	/// <summary>
+	/// Send an event at a simulated time
+	/// </summary>
+	/// <param name="time">Time in seconds from the start of the run</param>
+	/// <param name="e">Event</param>
+	void addEvent(float time, const sf::Event& e);
+
+	/// <summary>
+	/// Press and release the left mouse button at a simulated time
+	/// </summary>
+	/// <param name="time">Time in seconds from the start of the run</param>
+	/// <param name="pos">Position of the click in pixels</param>
+	void addClick(float time, const sf::Vector2i& pos = sf::Vector2i());
+
+	/// <summary>
+	/// Click at a fixed interval (i.e. to advance dialogue)
+	/// </summary>
+	/// <param name="start">Time of the first click</param>
+	/// <param name="interval">Time between clicks</param>
+	/// <param name="count">Number of clicks</param>
+	/// <param name="pos">Position of the clicks in pixels</param>
+	void addClicks(float start, float interval, Uint32 count, const sf::Vector2i& pos = sf::Vector2i());
+
+	/// <summary>
+	/// Press and release a key at a simulated time
+	/// </summary>
+	/// <param name="time">Time in seconds from the start of the run</param>
+	/// <param name="key">Key</param>
+	void addKeyPress(float time, sf::Keyboard::Key key);
+
+	/// <summary>
+	/// Remove all events
+	/// </summary>
+	void clearEvents();
+
+	/// <summary>
+	/// Start the engine and step it until it is closed, the current scene finishes with no events left to send,
+	/// or the time limit is reached
+	/// </summary>
+	/// <param name="maxTime">Max simulated time in seconds</param>
+	/// <returns>Run results</returns>
+	HeadlessStats run(float maxTime);
+
+	/// <summary>
+	/// Get the peak resident memory of the process
+	/// </summary>
+	/// <returns>Peak memory in bytes, or 0 if it isn't available</returns>
+	static Uint64 getPeakMemory();
+
+private:
+	/* Event sent at a simulated time */
+	struct ScriptEvent
+	{
+		float mTime;
+		sf::Event mEvent;
+	};
+
+private:
+	/// <summary>
+	/// Engine being driven
+	/// </summary>
+	Engine* mEngine;
+
+	/// <summary>
+	/// Simulated time of each frame
+	/// </summary>
+	float mFrameTime;
+
+	/// <summary>
+	/// Input script
+	/// </summary>
+	std::vector<ScriptEvent> mEvents;
+};
+
+// ============================================================================
+
+}
+
+#endif
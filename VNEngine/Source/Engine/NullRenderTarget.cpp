@@ -0,0 +1,34 @@
+#include <Engine/NullRenderTarget.h>
+
+using namespace vne;
+
+// ============================================================================
+// ============================================================================
+
+NullRenderTarget::NullRenderTarget() :
+	mSize			(0, 0)
+{
+
+}
+
+// ============================================================================
+
+void NullRenderTarget::create(Uint32 w, Uint32 h)
+{
+	mSize = sf::Vector2u(w, h);
+
+	// Reset the default view to the new size
+	initialize();
+}
+
+sf::Vector2u NullRenderTarget::getSize() const
+{
+	return mSize;
+}
+
+bool NullRenderTarget::setActive(bool active)
+{
+	return false;
+}
+
+// ============================================================================
@@ -0,0 +1,54 @@
+#ifndef NULL_RENDER_TARGET_H
+#define NULL_RENDER_TARGET_H
+
+#include <Core/DataTypes.h>
+
+#include <SFML/Graphics.hpp>
+
+namespace vne
+{
+
+// ============================================================================
+
+/// <summary>
+/// Render target that has a size and view but no OpenGL context.
+/// Drawables still build their geometry, but nothing is sent to the GPU.
+/// Used in headless mode, where there is no window or display
+/// </summary>
+class NullRenderTarget : public sf::RenderTarget
+{
+public:
+	NullRenderTarget();
+
+	/// <summary>
+	/// Set the size of the target in pixels
+	/// </summary>
+	/// <param name="w">Width</param>
+	/// <param name="h">Height</param>
+	void create(Uint32 w, Uint32 h);
+
+	/// <summary>
+	/// Get the size of the target in pixels
+	/// </summary>
+	/// <returns>Size</returns>
+	sf::Vector2u getSize() const override;
+
+	/// <summary>
+	/// There is no context to activate, so this always fails and draw calls are skipped
+	/// </summary>
+	/// <param name="active">Ignored</param>
+	/// <returns>False</returns>
+	bool setActive(bool active = true) override;
+
+private:
+	/// <summary>
+	/// Size in pixels
+	/// </summary>
+	sf::Vector2u mSize;
+};
+
+// ============================================================================
+
+}
+
+#endif
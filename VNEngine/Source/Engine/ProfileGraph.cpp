@@ -0,0 +1,100 @@
+#include <Engine/ProfileGraph.h>
+
+using namespace vne;
+
+// ============================================================================
+
+namespace
+{
+/* Phases shown in each bar, from the bottom up */
+const ProfileZone gZones[] =
+{
+	ProfileZone::Events,
+	ProfileZone::Update,
+	ProfileZone::Render,
+	ProfileZone::Display
+};
+
+const sf::Color gZoneColors[] =
+{
+	sf::Color(230, 200, 60),
+	sf::Color(80, 200, 90),
+	sf::Color(70, 140, 230),
+	sf::Color(150, 90, 200)
+};
+
+/* Width of one frame's bar in pixels */
+const float gBarWidth = 2.0f;
+}
+
+// ============================================================================
+// ============================================================================
+
+ProfileGraph::ProfileGraph() :
+	mScale			(4.0f),
+	mVertices		(sf::Quads)
+{
+
+}
+
+// ============================================================================
+
+void ProfileGraph::setScale(float scale)
+{
+	mScale = scale;
+}
+
+// ============================================================================
+
+void ProfileGraph::addRect(float x, float y, float w, float h, const sf::Color& color) const
+{
+	mVertices.append(sf::Vertex(sf::Vector2f(x, y), color));
+	mVertices.append(sf::Vertex(sf::Vector2f(x + w, y), color));
+	mVertices.append(sf::Vertex(sf::Vector2f(x + w, y + h), color));
+	mVertices.append(sf::Vertex(sf::Vector2f(x, y + h), color));
+}
+
+void ProfileGraph::draw(sf::RenderTarget& target, sf::RenderStates states) const
+{
+	FrameProfiler::getFrames(mFrames);
+	if (mFrames.empty()) return;
+
+	mVertices.clear();
+
+	float bottom = (float)target.getSize().y;
+	float width = FrameProfiler::MaxFrames * gBarWidth;
+
+	// Background covers up to 30 fps
+	addRect(0.0f, bottom - 33.3f * mScale, width, 33.3f * mScale, sf::Color(0, 0, 0, 160));
+
+	// Newest frame is on the right
+	float x = width - mFrames.size() * gBarWidth;
+	for (Uint32 i = 0; i < mFrames.size(); ++i, x += gBarWidth)
+	{
+		const ProfileFrame& frame = mFrames[i];
+
+		// Time outside of the timed phases is gray
+		float frameHeight = frame.mDuration * 1.0e-6f * mScale;
+		addRect(x, bottom - frameHeight, gBarWidth, frameHeight, sf::Color(120, 120, 120));
+
+		float y = bottom;
+		for (Uint32 j = 0; j < sizeof(gZones) / sizeof(gZones[0]); ++j)
+		{
+			float h = frame.getZoneTime(gZones[j]) * 1.0e-6f * mScale;
+			y -= h;
+			addRect(x, y, gBarWidth, h, gZoneColors[j]);
+		}
+	}
+
+	// Frame budget lines
+	addRect(0.0f, bottom - 16.7f * mScale, width, 1.0f, sf::Color::White);
+	addRect(0.0f, bottom - 33.3f * mScale, width, 1.0f, sf::Color::Red);
+
+	// Draw in pixels, then put the scene's view back
+	sf::View view = target.getView();
+	target.setView(target.getDefaultView());
+	target.draw(mVertices, states);
+	target.setView(view);
+}
+
+// ============================================================================
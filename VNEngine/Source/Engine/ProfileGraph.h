@@ -0,0 +1,66 @@
+#ifndef PROFILE_GRAPH_H
+#define PROFILE_GRAPH_H
+
+#include <Core/DataTypes.h>
+#include <Core/FrameProfiler.h>
+
+#include <SFML/Graphics.hpp>
+
+#include <vector>
+
+namespace vne
+{
+
+// ============================================================================
+
+/// <summary>
+/// On screen graph of the frame times recorded by the frame profiler.
+/// Each frame is a bar split into events, update, render, and display time,
+/// with lines at 60 and 30 frames per second. Drawn in pixels, in the bottom left corner of the target.
+/// Nothing is drawn unless VNE_PROFILER is defined
+/// </summary>
+class ProfileGraph : public sf::Drawable
+{
+public:
+	ProfileGraph();
+
+	/// <summary>
+	/// Set how many pixels tall one millisecond is
+	/// </summary>
+	/// <param name="scale">Pixels per millisecond</param>
+	void setScale(float scale);
+
+protected:
+	/// <summary>
+	/// Draw the graph using the target's default view
+	/// </summary>
+	/// <param name="target">Render target</param>
+	/// <param name="states">Render states</param>
+	void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+
+private:
+	/* Add a rectangle to the vertex array */
+	void addRect(float x, float y, float w, float h, const sf::Color& color) const;
+
+private:
+	/// <summary>
+	/// Pixels per millisecond
+	/// </summary>
+	float mScale;
+
+	/// <summary>
+	/// Frames copied from the profiler, reused between draws
+	/// </summary>
+	mutable std::vector<ProfileFrame> mFrames;
+
+	/// <summary>
+	/// Graph geometry, rebuilt every draw
+	/// </summary>
+	mutable sf::VertexArray mVertices;
+};
+
+// ============================================================================
+
+}
+
+#endif
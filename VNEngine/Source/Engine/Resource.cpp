@@ -7,10 +7,25 @@
 #ifndef _UNICODE
 #define _UNICODE
 #endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
 #endif
 #include <tinydir.h>
 #include <zlib.h>
 
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <string.h>
 #include <vector>
 #include <queue>
 
@@ -19,9 +34,29 @@ using namespace vne;
 // ============================================================================
 
 sf::String ResourceFolder::sResourcePath = "";
-FILE* ResourceFolder::sPackedFolder = 0;
-std::unordered_map<std::basic_string<Uint32>, Uint32> ResourceFolder::sPackedFolderMap;
+std::shared_ptr<PackFile> ResourceFolder::sPackedFolder;
+std::vector<PackEntry> ResourceFolder::sPackedIndex;
+std::vector<Uint32> ResourceFolder::sPackedNames;
 const Uint8* ResourceFolder::sResourceKey = 0;
+bool ResourceFolder::sIsMapped = true;
+
+bool gHeadless = false;
+
+/* Identifies version 2 and later packs, version 1 packs start with a file name length instead */
+const Uint32 gPackMagic = 0x4B504E56;
+
+/* Version written by ResourceFolder::pack() */
+const Uint32 gPackVersion = 2;
+
+/* First bytes of a version 2 pack. The index is stored after the file data, and the name table after the index */
+struct PackHeader
+{
+	Uint32 mMagic;
+	Uint32 mVersion;
+	Uint32 mNumEntries;
+	Uint32 mNumNameChars;
+	Uint64 mIndexOffset;
+};
 
 Uint8 gIV[] =
 {
@@ -45,48 +80,370 @@ Uint8 gIV[] =
 
 // ============================================================================
 
-void ResourceFolder::setPath(const sf::String& path)
+namespace
+{
+/* Round a size up to the AES block size */
+Uint32 padSize(Uint32 size)
+{
+	return size % 16 != 0 ? size + 16 - size % 16 : size;
+}
+
+/* Seek to a 64-bit offset */
+bool seekFile(FILE* f, Uint64 offset)
+{
+#ifdef _WIN32
+	return _fseeki64(f, (__int64)offset, SEEK_SET) == 0;
+#else
+	return fseeko(f, (off_t)offset, SEEK_SET) == 0;
+#endif
+}
+
+/* Get the 64-bit file position */
+Uint64 tellFile(FILE* f)
+{
+#ifdef _WIN32
+	return (Uint64)_ftelli64(f);
+#else
+	return (Uint64)ftello(f);
+#endif
+}
+
+bool compareHash(const PackEntry& a, const PackEntry& b)
+{
+	return a.mHash < b.mHash;
+}
+
+/* Hint that a range of the mapping is about to be read front to back */
+void adviseSequential(const Uint8* data, Uint64 size)
+{
+#ifndef _WIN32
+	// Advice applies to whole pages
+	uintptr_t pageSize = (uintptr_t)sysconf(_SC_PAGESIZE);
+	uintptr_t start = (uintptr_t)data & ~(pageSize - 1);
+	uintptr_t end = (uintptr_t)data + (uintptr_t)size;
+
+	madvise((void*)start, end - start, MADV_SEQUENTIAL);
+	madvise((void*)start, end - start, MADV_WILLNEED);
+#endif
+}
+}
+
+// ============================================================================
+
+namespace vne
+{
+/* Packed folder opened for reading. Reads are positional and the mapping is read-only, so any number of threads can read at once.
+   Views of stored entries hold a reference, so the file outlives setPath() */
+struct PackFile
+{
+	PackFile() :
+		mData		(0),
+		mSize		(0),
+#ifdef _WIN32
+		mFile		(INVALID_HANDLE_VALUE),
+		mMapping	(0)
+#else
+		mFd			(-1)
+#endif
+	{ }
+
+	~PackFile()
+	{
+#ifdef _WIN32
+		if (mData)
+			UnmapViewOfFile(mData);
+		if (mMapping)
+			CloseHandle(mMapping);
+		if (mFile != INVALID_HANDLE_VALUE)
+			CloseHandle(mFile);
+#else
+		if (mData)
+			munmap((void*)mData, (size_t)mSize);
+		if (mFd >= 0)
+			close(mFd);
+#endif
+	}
+
+	/* Open the file, returns false if it isn't a readable file */
+	bool open(const sf::String& path)
+	{
+#ifdef _WIN32
+		// Directories can't be opened without backup semantics.
+		// Reads on a handle opened without FILE_FLAG_OVERLAPPED are serialized, even with an offset
+		mFile = CreateFileW(path.toWideString().c_str(), GENERIC_READ, FILE_SHARE_READ, 0,
+			OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS | FILE_FLAG_OVERLAPPED, 0);
+		if (mFile == INVALID_HANDLE_VALUE) return false;
+
+		LARGE_INTEGER size;
+		if (!GetFileSizeEx(mFile, &size)) return false;
+		mSize = (Uint64)size.QuadPart;
+#else
+		mFd = ::open(path.toAnsiString().c_str(), O_RDONLY);
+		if (mFd < 0) return false;
+
+		struct stat info;
+		if (fstat(mFd, &info) != 0 || !S_ISREG(info.st_mode)) return false;
+		mSize = (Uint64)info.st_size;
+#endif
+
+		return true;
+	}
+
+	/* Map the whole file, reads fall back to the file if it can't be mapped */
+	void map()
+	{
+		if (!mSize) return;
+
+#ifdef _WIN32
+		mMapping = CreateFileMappingW(mFile, 0, PAGE_READONLY, 0, 0, 0);
+		if (!mMapping) return;
+
+		mData = (const Uint8*)MapViewOfFile(mMapping, FILE_MAP_READ, 0, 0, 0);
+#else
+		void* data = mmap(0, (size_t)mSize, PROT_READ, MAP_PRIVATE, mFd, 0);
+		if (data == MAP_FAILED) return;
+
+		// Entries are read in no particular order, so don't read ahead past the entry being opened
+		madvise(data, (size_t)mSize, MADV_RANDOM);
+		mData = (const Uint8*)data;
+#endif
+	}
+
+	/* Read from an offset without moving a shared file position */
+	bool read(Uint64 offset, void* dst, Uint32 size) const
+	{
+		if (offset + size > mSize) return false;
+
+		// Copy from the mapping if there is one
+		if (mData)
+		{
+			memcpy(dst, mData + offset, size);
+			return true;
+		}
+
+#ifdef _WIN32
+		// Each read waits on its own event, so reads from different threads can be in flight at once
+		OVERLAPPED overlapped = { };
+		overlapped.Offset = (DWORD)offset;
+		overlapped.OffsetHigh = (DWORD)(offset >> 32);
+		overlapped.hEvent = CreateEventW(0, TRUE, FALSE, 0);
+		if (!overlapped.hEvent) return false;
+
+		DWORD numRead = 0;
+		BOOL success = ReadFile(mFile, dst, size, 0, &overlapped);
+		if (success || GetLastError() == ERROR_IO_PENDING)
+			success = GetOverlappedResult(mFile, &overlapped, &numRead, TRUE);
+
+		CloseHandle(overlapped.hEvent);
+		return success && numRead == size;
+#else
+		Uint8* out = (Uint8*)dst;
+		while (size)
+		{
+			ssize_t numRead = pread(mFd, out, size, (off_t)offset);
+			if (numRead < 0 && errno == EINTR) continue;
+			if (numRead <= 0) return false;
+
+			out += numRead;
+			offset += (Uint64)numRead;
+			size -= (Uint32)numRead;
+		}
+
+		return true;
+#endif
+	}
+
+	/* Mapped file, or null if it isn't mapped */
+	const Uint8* mData;
+
+	/* Size of the file */
+	Uint64 mSize;
+
+#ifdef _WIN32
+	HANDLE mFile;
+	HANDLE mMapping;
+#else
+	int mFd;
+#endif
+};
+}
+
+// ============================================================================
+
+void vne::setHeadless(bool headless)
+{
+	gHeadless = headless;
+}
+
+bool vne::isHeadless()
+{
+	return gHeadless;
+}
+
+// ============================================================================
+
+bool ResourceFolder::setPath(const sf::String& path)
 {
+	// Close the previous packed folder, views of its mapping keep it open
+	sPackedFolder.reset();
+	sPackedIndex.clear();
+	sPackedNames.clear();
+
 	sResourcePath = path;
 
-	// Open and read header if it is a packed folder
-	sPackedFolder = FOPEN(path, "rb");
-	if (sPackedFolder)
+	// Open and read index if it is a packed folder
+	std::shared_ptr<PackFile> packed = std::make_shared<PackFile>();
+	if (!packed->open(path)) return true;
+	sPackedFolder = packed;
+
+	if (sIsMapped)
+		packed->map();
+
+	// Version 1 packs start with a file name length instead of the magic number
+	Uint32 magic = 0;
+	packed->read(0, &magic, sizeof(Uint32));
+
+	bool isValid = true;
+	if (magic == gPackMagic)
+		isValid = readIndex();
+	else
+		readLegacyIndex();
+
+	// A pack that can't be trusted is left empty, instead of opening the wrong data
+	if (!isValid || !checkIndex())
 	{
-		Uint32 fnameSize = 0;
+		sPackedIndex.clear();
+		sPackedNames.clear();
+		return false;
+	}
+
+	return true;
+}
 
-		// Read file name string size
-		// This read is used to determine when file is over
-		while (fread(&fnameSize, sizeof(Uint32), 1, sPackedFolder))
+void ResourceFolder::setMemoryMapped(bool mapped)
+{
+	sIsMapped = mapped;
+}
+
+bool ResourceFolder::readIndex()
+{
+	const PackFile& packed = *sPackedFolder;
+
+	PackHeader header;
+	if (!packed.read(0, &header, sizeof(PackHeader)) || header.mVersion != gPackVersion)
+		return false;
+
+	if (!header.mNumEntries)
+		return true;
+
+	// Sizes that can't fit in the file mean the header is damaged
+	if (header.mNumEntries > packed.mSize / sizeof(PackEntry) || header.mNumNameChars > packed.mSize / sizeof(Uint32))
+		return false;
+
+	// Read the whole index at once, it is already sorted
+	Uint32 indexSize = header.mNumEntries * (Uint32)sizeof(PackEntry);
+	sPackedIndex.resize(header.mNumEntries);
+	if (!packed.read(header.mIndexOffset, &sPackedIndex[0], indexSize))
+		return false;
+
+	// Names follow the index
+	sPackedNames.resize(header.mNumNameChars);
+	if (header.mNumNameChars && !packed.read(header.mIndexOffset + indexSize, &sPackedNames[0], header.mNumNameChars * (Uint32)sizeof(Uint32)))
+		return false;
+
+	return true;
+}
+
+void ResourceFolder::readLegacyIndex()
+{
+	const PackFile& packed = *sPackedFolder;
+
+	Uint32 fnameSize = 0;
+	Uint64 offset = 0;
+
+	// Read file name string size
+	// This read is used to determine when file is over
+	while (packed.read(offset, &fnameSize, sizeof(Uint32)))
+	{
+		offset += sizeof(Uint32);
+
+		// A name longer than the rest of the file means the pack is damaged
+		if (fnameSize > (packed.mSize - offset) / sizeof(Uint32)) break;
+
+		PackEntry entry;
+		entry.mNameOffset = (Uint32)sPackedNames.size();
+		entry.mNameSize = fnameSize;
+
+		// Read string straight into the name table
+		sPackedNames.resize(entry.mNameOffset + fnameSize);
+		if (fnameSize && !packed.read(offset, &sPackedNames[entry.mNameOffset], fnameSize * sizeof(Uint32))) break;
+		offset += fnameSize * sizeof(Uint32);
+
+		const Uint32* fname = sPackedNames.data() + entry.mNameOffset;
+		entry.mHash = NameId::hash(sf::String::fromUtf32(fname, fname + fnameSize));
+
+		// Read compression / encryption info, and file sizes
+		Uint8 info[2 + 2 * sizeof(Uint32)];
+		if (!packed.read(offset, info, sizeof(info))) break;
+		offset += sizeof(info);
+
+		entry.mFlags = (info[0] ? PackEntry::Compressed : 0) | (info[1] ? PackEntry::Encrypted : 0);
+		memcpy(&entry.mSize, info + 2, sizeof(Uint32));
+		memcpy(&entry.mStoredSize, info + 2 + sizeof(Uint32), sizeof(Uint32));
+		entry.mOffset = offset;
+
+		sPackedIndex.push_back(entry);
+
+		// Version 1 data is always padded, go to next file
+		offset += padSize(entry.mStoredSize);
+	}
+
+	std::stable_sort(sPackedIndex.begin(), sPackedIndex.end(), compareHash);
+}
+
+bool ResourceFolder::checkIndex()
+{
+	for (Uint32 i = 0; i < sPackedIndex.size(); ++i)
+	{
+		const PackEntry& entry = sPackedIndex[i];
+		if (entry.mNameOffset > sPackedNames.size() || entry.mNameSize > sPackedNames.size() - entry.mNameOffset)
+			return false;
+
+		// Entries with the same hash are next to each other, a name that is in there twice hides the second file
+		for (Uint32 j = i; j > 0 && sPackedIndex[j - 1].mHash == entry.mHash; --j)
 		{
-			// Read string
-			Uint32* fnameData = (Uint32*)malloc((fnameSize + 1) * sizeof(Uint32));
-			fread(fnameData, sizeof(Uint32), fnameSize, sPackedFolder);
-			fnameData[fnameSize] = 0;
-			sf::String fname(fnameData);
-			// Free string data
-			free(fnameData);
-
-			// Map file name to file offset
-			Uint32 fpos = (Uint32)ftell(sPackedFolder);
-			sPackedFolderMap[fname.toUtf32()] = fpos;
-
-			// Read to info bytes
-			Uint16 temp;
-			fread(&temp, 2, 1, sPackedFolder);
-
-			// Get file sizes
-			Uint32 u_size = 0, c_size = 0;
-			fread(&u_size, sizeof(Uint32), 1, sPackedFolder);
-			fread(&c_size, sizeof(Uint32), 1, sPackedFolder);
-			// Pad size
-			if (c_size % 16 != 0)
-				c_size += 16 - c_size % 16;
-
-			// Seek next file
-			fseek(sPackedFolder, c_size, SEEK_CUR);
+			const PackEntry& other = sPackedIndex[j - 1];
+			if (other.mNameSize == entry.mNameSize &&
+				std::equal(sPackedNames.begin() + entry.mNameOffset, sPackedNames.begin() + entry.mNameOffset + entry.mNameSize,
+					sPackedNames.begin() + other.mNameOffset))
+				return false;
 		}
 	}
+
+	return true;
+}
+
+bool ResourceFolder::isNamed(const PackEntry& entry, const sf::String& fname)
+{
+	if (entry.mNameSize != fname.getSize()) return false;
+
+	return !entry.mNameSize || memcmp(&sPackedNames[entry.mNameOffset], fname.getData(), entry.mNameSize * sizeof(Uint32)) == 0;
+}
+
+const PackEntry* ResourceFolder::findPacked(const sf::String& path)
+{
+	PackEntry key;
+	key.mHash = NameId::hash(path);
+
+	// Names with the same hash are told apart by comparing the names
+	auto it = std::lower_bound(sPackedIndex.begin(), sPackedIndex.end(), key, compareHash);
+	for (; it != sPackedIndex.end() && it->mHash == key.mHash; ++it)
+	{
+		if (isNamed(*it, path))
+			return &*it;
+	}
+
+	return 0;
 }
 
 // ============================================================================
@@ -99,66 +456,96 @@ void ResourceFolder::setKey(const Uint8* key)
 // ============================================================================
 
 Uint8* ResourceFolder::open(const sf::String& path, Uint32& size)
+{
+	ResourceData data;
+	if (!open(path, data)) return 0;
+
+	size = data.getSize();
+	return data.release();
+}
+
+bool ResourceFolder::open(const sf::String& path, ResourceData& data)
 {
 	if (sPackedFolder)
-		return openPacked(path, size);
+		return openPacked(path, data);
 	else
-		return openNormal(path, size);
+		return openNormal(path, data);
 }
 
 // ============================================================================
 
-Uint8* ResourceFolder::openNormal(const sf::String& path, Uint32& size)
+bool ResourceFolder::openNormal(const sf::String& path, ResourceData& data)
 {
 	// Open file
 	sf::String fname(sResourcePath + "/" + path);
 	FILE* f = FOPEN(fname, "rb");
-	if (!f) return 0;
+	if (!f) return false;
 
 	// Get file size
 	fseek(f, 0, SEEK_END);
-	size = (Uint32)ftell(f);
+	Uint32 size = (Uint32)ftell(f);
 	fseek(f, 0, SEEK_SET);
 
-	if (!size) return 0;
+	if (!size)
+	{
+		fclose(f);
+		return false;
+	}
 
 	// Allocate space and read data
-	Uint8* data = (Uint8*)malloc(size);
-	fread(data, size, 1, f);
+	Uint8* buffer = (Uint8*)malloc(size);
+	fread(buffer, size, 1, f);
+	fclose(f);
 
-	return data;
+	data.setOwned(buffer, size);
+	return true;
 }
 
 // ============================================================================
 
-Uint8* ResourceFolder::openPacked(const sf::String& path, Uint32& size)
+bool ResourceFolder::openPacked(const sf::String& path, ResourceData& data)
 {
-	// Get file offset
-	auto it = sPackedFolderMap.find(path.toUtf32());
-	if (it == sPackedFolderMap.end()) return 0;
-	Uint32 offset = it->second;
+	const PackEntry* entry = findPacked(path);
+	if (!entry) return false;
 
+	bool isCompressed = (entry->mFlags & PackEntry::Compressed) != 0;
+	bool isEncrypted = (entry->mFlags & PackEntry::Encrypted) != 0;
+	Uint32 u_size = entry->mSize;
+	Uint32 c_size = entry->mStoredSize;
 
-	// Go to offset
-	fseek(sPackedFolder, offset, SEEK_SET);
+	// Only encrypted data needs its padding
+	Uint32 c_size_p = isEncrypted ? padSize(c_size) : c_size;
+	if (!u_size || !c_size) return false;
+
+	// Find the stored data in the mapping
+	const Uint8* stored = 0;
+	if (sPackedFolder->mData && entry->mOffset + c_size_p <= sPackedFolder->mSize)
+	{
+		stored = sPackedFolder->mData + entry->mOffset;
+		adviseSequential(stored, c_size_p);
+
+		// Stored entries are used in place
+		if (!isCompressed && !isEncrypted)
+		{
+			data.setView(stored, u_size, sPackedFolder);
+			return true;
+		}
+	}
 
-	// Read compression / encryption info
-	bool isCompressed, isEncrypted;
-	fread(&isCompressed, sizeof(bool), 1, sPackedFolder);
-	fread(&isEncrypted, sizeof(bool), 1, sPackedFolder);
+	// Encrypted data is decrypted in place, so it always needs a copy
+	Uint8* c_data = 0;
+	if (isEncrypted || !stored)
+	{
+		c_data = (Uint8*)malloc(c_size_p);
 
-	// Read file sizes
-	Uint32 u_size, c_size;
-	fread(&u_size, sizeof(Uint32), 1, sPackedFolder);
-	fread(&c_size, sizeof(Uint32), 1, sPackedFolder);
-	// Pad compression size
-	Uint32 c_size_p = c_size;
-	if (c_size_p % 16 != 0)
-		c_size_p += 16 - c_size_p % 16;
+		if (!sPackedFolder->read(entry->mOffset, c_data, c_size_p))
+		{
+			free(c_data);
+			return false;
+		}
 
-	// Allocate and read data
-	Uint8* c_data = (Uint8*)malloc(c_size_p);
-	fread(c_data, c_size_p, 1, sPackedFolder);
+		stored = c_data;
+	}
 
 
 	// Decrypt
@@ -170,32 +557,34 @@ Uint8* ResourceFolder::openPacked(const sf::String& path, Uint32& size)
 	}
 
 
-	// Decompress
-	Uint8* u_data = c_data;
-	if (isCompressed)
+	// Decompress, straight from the mapping if the data isn't encrypted
+	if (!isCompressed)
 	{
-		u_data = (Uint8*)malloc(u_size);
-		int result = uncompress(u_data, (uLongf*)&u_size, c_data, c_size);
-
-		if (result < 0)
-			return 0;
+		data.setOwned(c_data, u_size);
+		return true;
 	}
 
+	Uint8* u_data = (Uint8*)malloc(u_size);
+	uLongf destSize = u_size;
+	int result = uncompress(u_data, &destSize, stored, c_size);
 
 	// Free compressed data if necessary
-	if (u_data != c_data)
-		free(c_data);
+	free(c_data);
 
+	if (result != Z_OK)
+	{
+		free(u_data);
+		return false;
+	}
 
-	// Return values
-	size = u_size;
-	return u_data;
+	data.setOwned(u_data, (Uint32)destSize);
+	return true;
 }
 
 // ============================================================================
 // ============================================================================
 
-void ResourceFolder::pack(const sf::String& dst)
+bool ResourceFolder::pack(const sf::String& dst)
 {
 	// Get length of directory path
 	Uint32 dirLen = (Uint32)sResourcePath.getSize() + 1;
@@ -249,32 +638,47 @@ void ResourceFolder::pack(const sf::String& dst)
 
 	// Open packed folder
 	FILE* packed = FOPEN(dst, "wb");
-	if (!packed)
-		packed = FOPEN(dst, "ab");
-	if (!packed) return;
+	if (!packed) return false;
+
+	// The header is written again with the index location once the data is written
+	PackHeader header;
+	header.mMagic = gPackMagic;
+	header.mVersion = gPackVersion;
+	header.mNumEntries = 0;
+	header.mNumNameChars = 0;
+	header.mIndexOffset = 0;
+	fwrite(&header, sizeof(PackHeader), 1, packed);
 
+	std::vector<PackEntry> index;
+	index.reserve(files.size());
+	std::vector<Uint32> names;
+
+	bool success = true;
 
 	for (Uint32 i = 0; i < files.size(); ++i)
 	{
 		FILE* f = FOPEN(files[i], "rb");
-		if (!f) continue;
+		if (!f)
+		{
+			success = false;
+			continue;
+		}
 
 		// Get file size
 		fseek(f, 0, SEEK_END);
 		Uint32 fsize = (Uint32)ftell(f);
 		fseek(f, 0, SEEK_SET);
 
-		if (!fsize) continue;
+		if (!fsize)
+		{
+			fclose(f);
+			continue;
+		}
 
 
-		// Calculate uncompressed sizes
+		// Create buffer using padded size, so it can be encrypted in place
 		Uint32 u_size = fsize;
-		Uint32 u_size_p = u_size;
-		if (u_size_p % 16 != 0)
-			u_size_p += 16 - u_size_p % 16;
-
-		// Create buffer using padded size
-		Uint8* u_data = (Uint8*)malloc(u_size_p);
+		Uint8* u_data = (Uint8*)malloc(padSize(u_size));
 		// Read data using unpadded size
 		fread(u_data, u_size, 1, f);
 
@@ -282,59 +686,46 @@ void ResourceFolder::pack(const sf::String& dst)
 		fclose(f);
 
 
-		// Calculate compressed size, compressed size is not certain yet, so don't calculate padded size yet
-		Uint32 c_size = (Uint32)(u_size * 1.1) + 12;
-
-		// Create buffer for compressed data
-		Uint8* c_data = (Uint8*)malloc(c_size);
+		// Create buffer for compressed data, padded for encryption
+		uLongf c_size = compressBound(u_size);
+		Uint8* c_data = (Uint8*)malloc(padSize((Uint32)c_size));
 		// Compress data
-		compress(c_data, (uLongf*)&c_size, u_data, u_size);
-
-		// Calculate compressed padded buffer size
-		Uint32 c_size_p = c_size;
-		if (c_size_p % 16 != 0)
-			c_size_p += 16 - c_size_p % 16;
+		bool isCompressed = compress(c_data, &c_size, u_data, u_size) == Z_OK && c_size < u_size;
 
-
-		// Determine which data to use based on their sizes
-		Uint8* f_data = c_data;
-		Uint32 f_u_size = u_size;
-		Uint32 f_c_size = c_size;
-		Uint32 f_c_size_p = c_size_p;
-		if (f_c_size >= f_u_size)
-		{
-			// Use uncompressed data if it is smaller than compressed version
-			f_data = u_data;
-			f_c_size = u_size;
-			f_c_size_p = u_size_p;
-		}
+		// Use uncompressed data if it is smaller than compressed version
+		Uint8* f_data = isCompressed ? c_data : u_data;
+		Uint32 f_size = isCompressed ? (Uint32)c_size : u_size;
+		Uint32 f_size_p = f_size;
 
 
 		// Encrypt data if key is provided
 		if (sResourceKey)
 		{
+			f_size_p = padSize(f_size);
+			memset(f_data + f_size, 0, f_size_p - f_size);
+
 			AES_ctx context;
 			AES_init_ctx_iv(&context, sResourceKey, gIV);
-			AES_CBC_encrypt_buffer(&context, f_data, f_c_size_p);
+			AES_CBC_encrypt_buffer(&context, f_data, f_size_p);
 		}
 
 
-		// Write filename
+		// Add to index, the name goes in the name table so lookups can check it
 		sf::String fname(files[i].substring(dirLen));
-		Uint32 fnameLen = fname.getSize();
-		fwrite(&fnameLen, sizeof(Uint32), 1, packed);
-		fwrite(fname.getData(), sizeof(Uint32), fnameLen, packed);
 
-		// Write compression / encryption info
-		bool isCompressed = f_data == c_data;
-		bool isEncrypted = sResourceKey ? true : false;
-		fwrite(&isCompressed, sizeof(bool), 1, packed);
-		fwrite(&isEncrypted, sizeof(bool), 1, packed);
+		PackEntry entry;
+		entry.mHash = NameId::hash(fname);
+		entry.mNameOffset = (Uint32)names.size();
+		entry.mNameSize = (Uint32)fname.getSize();
+		names.insert(names.end(), fname.getData(), fname.getData() + fname.getSize());
+		entry.mFlags = (isCompressed ? PackEntry::Compressed : 0) | (sResourceKey ? PackEntry::Encrypted : 0);
+		entry.mOffset = tellFile(packed);
+		entry.mSize = u_size;
+		entry.mStoredSize = f_size;
+		index.push_back(entry);
 
 		// Write data
-		fwrite(&f_u_size, sizeof(Uint32), 1, packed);
-		fwrite(&f_c_size, sizeof(Uint32), 1, packed);
-		fwrite(f_data, f_c_size_p, 1, packed);
+		fwrite(f_data, f_size_p, 1, packed);
 
 
 		// Free data
@@ -342,8 +733,133 @@ void ResourceFolder::pack(const sf::String& dst)
 		free(c_data);
 	}
 
+
+	// Sort the index for lookups by hash, files with the same hash are told apart by name
+	std::stable_sort(index.begin(), index.end(), compareHash);
+
+	// Write index and names after the data, then point the header at them
+	header.mNumEntries = (Uint32)index.size();
+	header.mNumNameChars = (Uint32)names.size();
+	header.mIndexOffset = tellFile(packed);
+	if (!index.empty())
+		fwrite(&index[0], sizeof(PackEntry), index.size(), packed);
+	if (!names.empty())
+		fwrite(&names[0], sizeof(Uint32), names.size(), packed);
+
+	seekFile(packed, 0);
+	fwrite(&header, sizeof(PackHeader), 1, packed);
+
 	// Close packed folder
+	if (ferror(packed))
+		success = false;
 	fclose(packed);
+
+	return success;
+}
+
+// ============================================================================
+// ============================================================================
+
+ResourceData::ResourceData() :
+	mData		(0),
+	mSize		(0)
+{
+
+}
+
+ResourceData::ResourceData(ResourceData&& other) :
+	mData		(other.mData),
+	mSize		(other.mSize),
+	mOwner		(std::move(other.mOwner))
+{
+	other.mData = 0;
+	other.mSize = 0;
+}
+
+ResourceData::~ResourceData()
+{
+	reset();
+}
+
+ResourceData& ResourceData::operator=(ResourceData&& other)
+{
+	if (this != &other)
+	{
+		reset();
+
+		mData = other.mData;
+		mSize = other.mSize;
+		mOwner = std::move(other.mOwner);
+
+		other.mData = 0;
+		other.mSize = 0;
+	}
+
+	return *this;
+}
+
+// ============================================================================
+
+void ResourceData::setOwned(Uint8* data, Uint32 size)
+{
+	reset();
+
+	mData = data;
+	mSize = size;
+}
+
+void ResourceData::setView(const Uint8* data, Uint32 size, const std::shared_ptr<const void>& owner)
+{
+	reset();
+
+	mData = data;
+	mSize = size;
+	mOwner = owner;
+}
+
+void ResourceData::reset()
+{
+	// Owned data has no owner object
+	if (!mOwner)
+		free((void*)mData);
+
+	mData = 0;
+	mSize = 0;
+	mOwner.reset();
+}
+
+Uint8* ResourceData::release()
+{
+	Uint8* data = (Uint8*)mData;
+
+	if (mOwner)
+	{
+		data = (Uint8*)malloc(mSize);
+		memcpy(data, mData, mSize);
+		mOwner.reset();
+	}
+
+	mData = 0;
+	mSize = 0;
+
+	return data;
+}
+
+// ============================================================================
+
+const Uint8* ResourceData::getData() const
+{
+	return mData;
+}
+
+Uint32 ResourceData::getSize() const
+{
+	return mSize;
+}
+
+bool ResourceData::isView() const
+{
+	return mOwner != 0;
 }
 
 // ============================================================================
@@ -351,7 +867,7 @@ void ResourceFolder::pack(const sf::String& dst)
 
 ResourceInfo::ResourceInfo() :
 	mResource		(0),
-	mData			(0)
+	mHandle			(0)
 {
 
 }
@@ -1,15 +1,20 @@
 #ifndef RESOURCE_H
 #define RESOURCE_H
 
-#include <Core/ObjectPool.h>
+#include <Core/SlotMap.h>
 #include <Core/Macros.h>
+#include <Core/NameId.h>
+
+#include <Engine/ResourceLoader.h>
 
 #include <SFML/System.hpp>
 #include <SFML/Graphics.hpp>
 #include <SFML/Audio.hpp>
 
+#include <memory>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 #include <aes.hpp>
 
 // ============================================================================
@@ -35,6 +40,101 @@ namespace vne
 
 // ============================================================================
 
+/// <summary>
+/// Set if the engine runs without a window, GPU, or audio device.
+/// Textures, music, and sound buffers are not loaded in headless mode, getting them returns NULL
+/// </summary>
+/// <param name="headless">Headless flag</param>
+void setHeadless(bool headless);
+
+/// <summary>
+/// Returns true if the engine runs in headless mode
+/// </summary>
+/// <returns>Boolean</returns>
+bool isHeadless();
+
+// ============================================================================
+
+/// <summary>
+/// File data opened from the resource folder.
+/// The data is either a copy that the object frees, or a view of memory owned by another object (i.e. the mapped packed folder),
+/// which is kept alive for as long as the view exists
+/// </summary>
+class ResourceData
+{
+public:
+	ResourceData();
+	ResourceData(ResourceData&& other);
+	~ResourceData();
+
+	ResourceData& operator=(ResourceData&& other);
+
+	ResourceData(const ResourceData&) = delete;
+	ResourceData& operator=(const ResourceData&) = delete;
+
+	/// <summary>
+	/// Take ownership of data allocated with malloc
+	/// </summary>
+	/// <param name="data">Data</param>
+	/// <param name="size">Size of data in bytes</param>
+	void setOwned(Uint8* data, Uint32 size);
+
+	/// <summary>
+	/// Point to memory owned by another object without copying it
+	/// </summary>
+	/// <param name="data">Data</param>
+	/// <param name="size">Size of data in bytes</param>
+	/// <param name="owner">Object that owns the memory, kept alive until the view is reset</param>
+	void setView(const Uint8* data, Uint32 size, const std::shared_ptr<const void>& owner);
+
+	/// <summary>
+	/// Free the data, or drop the view
+	/// </summary>
+	void reset();
+
+	/// <summary>
+	/// Give up ownership of the data, the caller has to free it. Views are copied first
+	/// </summary>
+	/// <returns>Data allocated with malloc</returns>
+	Uint8* release();
+
+	/// <summary>
+	/// Get the data
+	/// </summary>
+	/// <returns>Pointer to data</returns>
+	const Uint8* getData() const;
+
+	/// <summary>
+	/// Get the size of the data in bytes
+	/// </summary>
+	/// <returns>Size</returns>
+	Uint32 getSize() const;
+
+	/// <summary>
+	/// Returns true if the data is a view of memory owned by another object
+	/// </summary>
+	/// <returns>Boolean</returns>
+	bool isView() const;
+
+private:
+	/// <summary>
+	/// Pointer to the data
+	/// </summary>
+	const Uint8* mData;
+
+	/// <summary>
+	/// Size of the data
+	/// </summary>
+	Uint32 mSize;
+
+	/// <summary>
+	/// Owner of the memory if the data is a view
+	/// </summary>
+	std::shared_ptr<const void> mOwner;
+};
+
+// ============================================================================
+
 struct ResourceInfo
 {
 	ResourceInfo();
@@ -44,32 +144,112 @@ struct ResourceInfo
 	/// </summary>
 	void* mResource;
 
+	/// <summary>
+	/// Slot map handle value of the resource object
+	/// </summary>
+	Uint32 mHandle;
+
 	/// <summary>
 	/// File name of resource to load. Empty if resource was created instead of loaded
 	/// </summary>
 	sf::String mFileName;
 
 	/// <summary>
-	/// Data the resource uses that must be freed after use
+	/// File data the resource keeps using after it is loaded
+	/// </summary>
+	ResourceData mData;
+
+	/// <summary>
+	/// Background load that is in progress, or null
+	/// </summary>
+	std::shared_ptr<LoadRequest> mRequest;
+};
+
+// ============================================================================
+
+/// <summary>
+/// Entry in the index of a packed folder.
+/// Version 2 packs store a table of these sorted by hash, followed by a table of the file names.
+/// Version 1 packs are scanned into the same tables when opened
+/// </summary>
+struct PackEntry
+{
+	enum Flags
+	{
+		/// <summary>
+		/// Stored data is compressed with zlib
+		/// </summary>
+		Compressed = 1 << 0,
+
+		/// <summary>
+		/// Stored data is encrypted with AES-128 CBC, and padded to 16 bytes
+		/// </summary>
+		Encrypted = 1 << 1
+	};
+
+	/// <summary>
+	/// Hash of the file name (see NameId::hash)
+	/// </summary>
+	Uint32 mHash;
+
+	/// <summary>
+	/// Codec flags
+	/// </summary>
+	Uint32 mFlags;
+
+	/// <summary>
+	/// Offset of the stored data in the pack
+	/// </summary>
+	Uint64 mOffset;
+
+	/// <summary>
+	/// Size of the file after it is decoded
+	/// </summary>
+	Uint32 mSize;
+
+	/// <summary>
+	/// Size of the stored data, not including encryption padding
+	/// </summary>
+	Uint32 mStoredSize;
+
+	/// <summary>
+	/// Offset of the file name in the name table, in code points
 	/// </summary>
-	Uint8* mData;
+	Uint32 mNameOffset;
+
+	/// <summary>
+	/// Length of the file name in code points
+	/// </summary>
+	Uint32 mNameSize;
 };
 
 // ============================================================================
 
+struct PackFile;
+
 /// <summary>
 /// Handles opening files if using normal files system.
-/// Decrypt and uncompresses if using packed resource file
+/// Decrypt and uncompresses if using packed resource file.
+/// Files can be opened from any number of threads at once, but the path and key must not change while files are being opened
 /// </summary>
 class ResourceFolder
 {
 public:
 	/// <summary>
 	/// Set path to resource folder.
-	/// This can be a directory or the packed resource folder
+	/// This can be a directory or the packed resource folder. Version 2 packs are opened with a single read of their index,
+	/// older packs are scanned entry by entry. Packed folders are memory mapped when possible
 	/// </summary>
 	/// <param name="path">Path to resource folder</param>
-	static void setPath(const sf::String& path);
+	/// <returns>False if the path is a packed folder with a damaged index or the same file twice, no files can be opened from it</returns>
+	static bool setPath(const sf::String& path);
+
+	/// <summary>
+	/// Set if packed folders are memory mapped (on by default). Unmapped packs are read with positional reads.
+	/// Takes effect the next time the path is set
+	/// </summary>
+	/// <param name="mapped">Mapped flag</param>
+	static void setMemoryMapped(bool mapped);
 
 	/// <summary>
 	/// Set resource key used to encrypt / decrypt resource folder
@@ -87,15 +267,40 @@ public:
 	static Uint8* open(const sf::String& fname, Uint32& size);
 
 	/// <summary>
-	/// Pack current directory into packed folder with options for encryption
+	/// Open a file from the resource folder, without copying it when possible.
+	/// Files that are stored in a mapped packed folder without compression or encryption are returned as views of the mapping
+	/// </summary>
+	/// <param name="fname">Path to file to load</param>
+	/// <param name="data">File data</param>
+	/// <returns>True if the file was opened</returns>
+	static bool open(const sf::String& fname, ResourceData& data);
+
+	/// <summary>
+	/// Pack current directory into a version 2 packed folder, encrypted if a key is set
 	/// </summary>
 	/// <param name="dst">Output file</param>
-	/// <param name="key">Pointer to key buffer</param>
-	static void pack(const sf::String& dst);
+	/// <returns>True if every file was packed</returns>
+	static bool pack(const sf::String& dst);
+
+	/// <summary>
+	/// Find a file in the packed folder index by hash, then by name. Doesn't allocate
+	/// </summary>
+	/// <param name="fname">Path to file</param>
+	/// <returns>Index entry, or NULL if the file isn't in the packed folder</returns>
+	static const PackEntry* findPacked(const sf::String& fname);
 
 private:
-	static Uint8* openPacked(const sf::String& fname, Uint32& size);
-	static Uint8* openNormal(const sf::String& fname, Uint32& size);
+	static bool openPacked(const sf::String& fname, ResourceData& data);
+	static bool openNormal(const sf::String& fname, ResourceData& data);
+
+	/* Read the index of a version 2 pack, returns false if it is damaged or a newer version */
+	static bool readIndex();
+	/* Scan the entries of a version 1 pack into the index */
+	static void readLegacyIndex();
+	/* Check that every name is in the name table and no file is in the index twice */
+	static bool checkIndex();
+	/* Returns true if an entry has the given name */
+	static bool isNamed(const PackEntry& entry, const sf::String& fname);
 
 private:
 	/// <summary>
@@ -104,19 +309,67 @@ private:
 	static sf::String sResourcePath;
 
 	/// <summary>
-	/// File pointer for packed folder
+	/// Packed folder, or null if the resource folder is a directory
+	/// </summary>
+	static std::shared_ptr<PackFile> sPackedFolder;
+
+	/// <summary>
+	/// Index of the packed folder, sorted by hash
 	/// </summary>
-	static FILE* sPackedFolder;
+	static std::vector<PackEntry> sPackedIndex;
 
 	/// <summary>
-	/// Maps file names to file offsets in a packed folder
+	/// File names of the packed folder as UTF-32 code points, the index points into this
 	/// </summary>
-	static std::unordered_map<std::basic_string<Uint32>, Uint32> sPackedFolderMap;
+	static std::vector<Uint32> sPackedNames;
 
 	/// <summary>
 	/// Keep a pointer to encryption key
 	/// </summary>
 	static const Uint8* sResourceKey;
+
+	/// <summary>
+	/// True if packed folders are memory mapped
+	/// </summary>
+	static bool sIsMapped;
+};
+
+// ============================================================================
+
+template <typename T>
+class LoadHandle;
+
+template <typename T>
+class ResourceRequest;
+
+/// <summary>
+/// Data produced by the part of a load that can run on a worker thread, before the resource object is created.
+/// Specialized for types that decode files into something other than the raw file data
+/// </summary>
+template <typename T>
+struct ResourceDecode
+{
+
+};
+
+/// <summary>
+/// Decoded image, uploaded to the texture on the main thread
+/// </summary>
+template <>
+struct ResourceDecode<sf::Texture>
+{
+	sf::Image mImage;
+};
+
+/// <summary>
+/// Decoded audio samples, copied to the sound buffer on the main thread
+/// </summary>
+template <>
+struct ResourceDecode<sf::SoundBuffer>
+{
+	std::vector<sf::Int16> mSamples;
+	Uint32 mChannelCount;
+	Uint32 mSampleRate;
 };
 
 // ============================================================================
@@ -134,17 +387,19 @@ public:
 	/// </summary>
 	/// <param name="name">The name of the object</param>
 	/// <returns>A pointer to the new object</returns>
-	static T* create(const sf::String& name)
+	static T* create(NameId name)
 	{
 		// Get resource info
-		ResourceInfo& info = sResourceMap[name.toUtf32()];
+		ResourceInfo& info = sResourceMap[name];
 		
 		// Return object if it exists
 		if (info.mResource)
 			return (T*)info.mResource;
 
-		// Create object from pool
-		info.mResource = sResourcePool.create();
+		// Create object from slot map
+		Handle<T> handle = sResources.create();
+		info.mHandle = handle.getValue();
+		info.mResource = sResources.get(handle);
 
 		return (T*)info.mResource;
 	}
@@ -154,10 +409,10 @@ public:
 	/// </summary>
 	/// <param name="path">File path to the resource being loaded</param>
 	/// <param name="name">Name to assign the resource</param>
-	static void addLocation(const sf::String& path, const sf::String& name)
+	static void addLocation(const sf::String& path, NameId name)
 	{
 		// Get resource info
-		ResourceInfo& info = sResourceMap[name.toUtf32()];
+		ResourceInfo& info = sResourceMap[name];
 
 		// Only set file name if object doesn't exist
 		if (!info.mResource)
@@ -171,47 +426,82 @@ public:
 	/// </summary>
 	/// <param name="name">Name of resource to retrieve</param>
 	/// <returns>Pointer to resource</returns>
-	static T* get(const sf::String& name)
+	static T* get(NameId name)
 	{
-		// Get resource info
-		ResourceInfo& info = sResourceMap[name.toUtf32()];
+		return (T*)getInfo(name).mResource;
+	}
 
-		// If there is a file name and resource hasn't been created yet, load file
-		if (info.mFileName.getSize() && !info.mResource)
-		{
-			info.mResource = sResourcePool.create();
-			if (!load((T*)info.mResource, info.mFileName, info.mData))
-			{
-				// If failed to load, free object and return NULL
-				sResourcePool.free((T*)info.mResource);
-				info.mResource = 0;
-				info.mData = 0;
+	/// <summary>
+	/// Start loading a resource in the background and return a handle to wait on.
+	/// Reading and decoding runs on the resource loader's worker threads, and the resource is created on the main thread
+	/// during a later frame. Calling get() before the load is done finishes it immediately.
+	/// If the loader isn't running, the resource is loaded before this returns
+	/// </summary>
+	/// <param name="name">Name of resource to load</param>
+	/// <returns>Load handle</returns>
+	static LoadHandle<T> requestLoad(NameId name)
+	{
+		ResourceInfo& info = sResourceMap[name];
 
-				return 0;
-			}
+		// Nothing to do if the resource exists, can't be loaded, or is already loading
+		if (info.mRequest || info.mResource || !info.mFileName.getSize() || !canLoad())
+			return LoadHandle<T>(name, info.mRequest);
+
+		if (!ResourceLoader::isRunning())
+		{
+			getInfo(name);
+			return LoadHandle<T>(name, 0);
 		}
 
-		return (T*)info.mResource;
+		info.mRequest = std::make_shared<ResourceRequest<T>>(name, info.mFileName);
+		ResourceLoader::submit(info.mRequest);
+
+		return LoadHandle<T>(name, info.mRequest);
+	}
+
+	/// <summary>
+	/// Get a handle to a resource by name.
+	/// For loadable resources, the resource is loaded if it hasn't been loaded.
+	/// Returns a null handle if it doesn't exist.
+	/// Unlike a pointer, the handle can be checked to see if the resource was freed
+	/// </summary>
+	/// <param name="name">Name of resource to retrieve</param>
+	/// <returns>Resource handle</returns>
+	static Handle<T> getHandle(NameId name)
+	{
+		return Handle<T>(getInfo(name).mHandle);
+	}
+
+	/// <summary>
+	/// Get resource from a handle.
+	/// Returns NULL if the resource was freed
+	/// </summary>
+	/// <param name="handle">Resource handle</param>
+	/// <returns>Pointer to resource</returns>
+	static T* get(Handle<T> handle)
+	{
+		return sResources.get(handle);
 	}
 
 	/// <summary>
 	/// Free a resource by name
 	/// </summary>
 	/// <param name="name">Name of the resource to free</param>
-	static void free(const sf::String& name)
+	static void free(NameId name)
 	{
 		// Get resource info
-		ResourceInfo& info = sResourceMap[name.toUtf32()];
+		ResourceInfo& info = sResourceMap[name];
+
+		// Drop any background load, it is ignored when it finishes
+		info.mRequest.reset();
 
 		// If object exists, free and reset object
 		if (info.mResource)
 		{
-			if (info.mData)
-				std::free(info.mData);
-
-			sResourcePool.free((T*)info.mResource);
+			sResources.free(Handle<T>(info.mHandle));
 			info.mResource = 0;
-			info.mData = 0;
+			info.mHandle = 0;
+			info.mData.reset();
 		}
 	}
 
@@ -220,129 +510,466 @@ public:
 	/// </summary>
 	static void free()
 	{
-		sResourcePool.free();
+		sResources.clear();
+
+		// Resource data is freed with the map, after the resource objects are cleared
+		sResourceMap.clear();
+	}
 
-		// Free all resource data after clearing resource objects
-		for (auto it = sResourceMap.begin(); it != sResourceMap.end(); ++it)
+private:
+	/// <summary>
+	/// Get resource info by name, and load the resource if it hasn't been loaded
+	/// </summary>
+	/// <param name="name">Name of resource</param>
+	/// <returns>Resource info</returns>
+	static ResourceInfo& getInfo(NameId name)
+	{
+		// Get resource info
+		ResourceInfo& info = sResourceMap[name];
+
+		// Finish a background load now instead of loading the file again
+		if (info.mRequest)
 		{
-			if (it->second.mData)
-				std::free(it->second.mData);
+			std::shared_ptr<LoadRequest> request = info.mRequest;
+			ResourceLoader::wait(request.get());
 		}
 
-		sResourceMap.clear();
+		// If there is a file name and resource hasn't been created yet, load file
+		if (info.mFileName.getSize() && !info.mResource && canLoad())
+		{
+			Handle<T> handle = sResources.create();
+			T* object = sResources.get(handle);
+
+			if (!load(object, info.mFileName, info.mData))
+			{
+				// If failed to load, free object and any data it kept
+				sResources.free(handle);
+				info.mData.reset();
+			}
+			else
+			{
+				info.mResource = object;
+				info.mHandle = handle.getValue();
+			}
+		}
+
+		return info;
 	}
 
-private:
 	/// <summary>
-	/// Load resource from file.
-	/// This function is meant to be specialized for each type
+	/// Create the resource object from a finished background load. Called on the main thread
+	/// </summary>
+	/// <param name="name">Name of resource</param>
+	/// <param name="request">Finished request</param>
+	/// <param name="decoded">True if the request decoded its file</param>
+	/// <returns>True if the resource was created</returns>
+	static bool finishRequest(NameId name, ResourceRequest<T>* request, bool decoded)
+	{
+		// Skip requests that were freed or replaced while they were loading
+		auto it = sResourceMap.find(name);
+		if (it == sResourceMap.end() || it->second.mRequest.get() != request)
+			return false;
+
+		ResourceInfo& info = it->second;
+		info.mRequest.reset();
+
+		if (!decoded) return false;
+		if (info.mResource) return true;
+
+		Handle<T> handle = sResources.create();
+		T* object = sResources.get(handle);
+
+		if (!finalize(object, request->mData, request->mDecoded))
+		{
+			sResources.free(handle);
+			return false;
+		}
+
+		// The resource keeps the data it still uses
+		info.mResource = object;
+		info.mHandle = handle.getValue();
+		info.mData = std::move(request->mData);
+
+		return true;
+	}
+
+	/// <summary>
+	/// Load resource from file on the calling thread
 	/// </summary>
 	/// <param name="object">The object to load</param>
+	/// <param name="fname">File name</param>
+	/// <param name="data">Data the resource keeps</param>
+	/// <returns>True if there were no errors</returns>
+	static bool load(T* object, const sf::String& fname, ResourceData& data)
+	{
+		ResourceDecode<T> decoded;
+
+		if (!decode(fname, data, decoded))
+			return false;
+
+		return finalize(object, data, decoded);
+	}
+
+	/// <summary>
+	/// Read and decode a file, without touching the resource object, so it can run on any thread.
+	/// This function is meant to be specialized for each type
+	/// </summary>
+	/// <param name="fname">File name</param>
+	/// <param name="data">File data that is still needed to create the object, reset if it isn't</param>
+	/// <param name="decoded">Decoded data</param>
 	/// <returns>True if there were no errors</returns>
-	static bool load(T* object, const sf::String& fname, Uint8*& data)
+	static bool decode(const sf::String& fname, ResourceData& data, ResourceDecode<T>& decoded)
 	{
 		// Default nonloadable
 		return false;
 	}
 
+	/// <summary>
+	/// Create the resource object from decoded data. Called on the main thread.
+	/// This function is meant to be specialized for each type
+	/// </summary>
+	/// <param name="object">The object to load</param>
+	/// <param name="data">File data, kept by the resource if it isn't reset</param>
+	/// <param name="decoded">Decoded data</param>
+	/// <returns>True if there were no errors</returns>
+	static bool finalize(T* object, ResourceData& data, ResourceDecode<T>& decoded)
+	{
+		return false;
+	}
+
+	/// <summary>
+	/// Returns true if resources of this type can be created right now.
+	/// This function is meant to be specialized for types that need a device
+	/// </summary>
+	/// <returns>Boolean</returns>
+	static bool canLoad()
+	{
+		return true;
+	}
+
 private:
 	/// <summary>
-	/// Data pool that holds all resources of type T
+	/// Slot map that holds all resources of type T
 	/// </summary>
-	static ObjectPool<T> sResourcePool;
+	static SlotMap<T> sResources;
 
 	/// <summary>
 	/// Maps resource name to object pointers
 	/// </summary>
-	static std::unordered_map<std::basic_string<Uint32>, ResourceInfo> sResourceMap;
+	static std::unordered_map<NameId, ResourceInfo> sResourceMap;
+
+	friend class ResourceRequest<T>;
 };
 
 template <typename T>
-ObjectPool<T> Resource<T>::sResourcePool;
+SlotMap<T> Resource<T>::sResources;
 
 template <typename T>
-std::unordered_map<std::basic_string<Uint32>, ResourceInfo> Resource<T>::sResourceMap;
+std::unordered_map<NameId, ResourceInfo> Resource<T>::sResourceMap;
 
 // ============================================================================
 
+/// <summary>
+/// Decode an image, this part of a texture load doesn't need OpenGL
+/// </summary>
+template <>
+inline bool Resource<sf::Texture>::decode(const sf::String& fname, ResourceData& data, ResourceDecode<sf::Texture>& decoded)
+{
+	if (!ResourceFolder::open(fname, data)) return false;
 
+	bool success = decoded.mImage.loadFromMemory(data.getData(), data.getSize());
+	data.reset();
 
-// ============================================================================
+	return success;
+}
 
 /// <summary>
-/// Load SFML texture
+/// Upload the decoded image to the texture
 /// </summary>
 template <>
-inline bool Resource<sf::Texture>::load(sf::Texture* object, const sf::String& fname, Uint8*& data)
+inline bool Resource<sf::Texture>::finalize(sf::Texture* object, ResourceData& data, ResourceDecode<sf::Texture>& decoded)
 {
-	Uint32 size = 0;
-	data = ResourceFolder::open(fname, size);
-	if (! data || !size) return false;
+	if (!object->loadFromImage(decoded.mImage))
+		return false;
 
-	bool success = object->loadFromMemory(data, size);
-	std::free(data);
-	data = 0;
+	// Enable smooth filter
+	object->setSmooth(true);
 
-	if (success)
-	{
-		// Enable smooth filter
-		object->setSmooth(true);
-	}
+	return true;
+}
 
-	return success;
+/// <summary>
+/// Textures can't be constructed without an OpenGL context
+/// </summary>
+template <>
+inline bool Resource<sf::Texture>::canLoad()
+{
+	return !isHeadless();
 }
 
 // ============================================================================
 
 /// <summary>
-/// Load SFML font
+/// Read a font file
 /// </summary>
 template <>
-inline bool Resource<sf::Font>::load(sf::Font* object, const sf::String& fname, Uint8*& data)
+inline bool Resource<sf::Font>::decode(const sf::String& fname, ResourceData& data, ResourceDecode<sf::Font>& decoded)
 {
-	Uint32 size = 0;
-	data = ResourceFolder::open(fname, size);
-	if (!data || !size) return false;
+	return ResourceFolder::open(fname, data);
+}
 
-	return object->loadFromMemory(data, size);
+/// <summary>
+/// Load SFML font, the font reads from the file data for as long as it exists
+/// </summary>
+template <>
+inline bool Resource<sf::Font>::finalize(sf::Font* object, ResourceData& data, ResourceDecode<sf::Font>& decoded)
+{
+	return object->loadFromMemory(data.getData(), data.getSize());
 }
 
 // ============================================================================
 
 /// <summary>
-/// Load SFML sound buffer, which is used to play Sound
+/// Decode all samples of a sound file
 /// </summary>
 template <>
-inline bool Resource<sf::SoundBuffer>::load(sf::SoundBuffer* object, const sf::String& fname, Uint8*& data)
+inline bool Resource<sf::SoundBuffer>::decode(const sf::String& fname, ResourceData& data, ResourceDecode<sf::SoundBuffer>& decoded)
 {
-	Uint32 size = 0;
-	data = ResourceFolder::open(fname, size);
-	if (!data || !size) return false;
+	if (!ResourceFolder::open(fname, data)) return false;
 
-	bool success = object->loadFromMemory(data, size);
-	std::free(data);
-	data = 0;
+	sf::InputSoundFile file;
+	bool success = file.openFromMemory(data.getData(), data.getSize());
+	if (success)
+	{
+		decoded.mSamples.resize((size_t)file.getSampleCount());
+		decoded.mChannelCount = file.getChannelCount();
+		decoded.mSampleRate = file.getSampleRate();
+
+		if (!decoded.mSamples.empty())
+			success = file.read(&decoded.mSamples[0], decoded.mSamples.size()) == decoded.mSamples.size();
+	}
+
+	data.reset();
 
 	return success;
 }
 
+/// <summary>
+/// Copy the decoded samples to the sound buffer
+/// </summary>
+template <>
+inline bool Resource<sf::SoundBuffer>::finalize(sf::SoundBuffer* object, ResourceData& data, ResourceDecode<sf::SoundBuffer>& decoded)
+{
+	if (decoded.mSamples.empty()) return false;
+
+	return object->loadFromSamples(&decoded.mSamples[0], decoded.mSamples.size(), decoded.mChannelCount, decoded.mSampleRate);
+}
+
+/// <summary>
+/// Sound buffers aren't loaded without an audio device
+/// </summary>
+template <>
+inline bool Resource<sf::SoundBuffer>::canLoad()
+{
+	return !isHeadless();
+}
+
 // ============================================================================
 
 /// <summary>
-/// Load SFML music
+/// Read a music file
 /// </summary>
 template <>
-inline bool Resource<sf::Music>::load(sf::Music* object, const sf::String& fname, Uint8*& data)
+inline bool Resource<sf::Music>::decode(const sf::String& fname, ResourceData& data, ResourceDecode<sf::Music>& decoded)
 {
-	Uint32 size = 0;
-	data = ResourceFolder::open(fname, size);
-	if (!data || !size) return false;
+	return ResourceFolder::open(fname, data);
+}
 
-	return object->openFromMemory(data, size);
+/// <summary>
+/// Open SFML music, it streams from the file data for as long as it exists
+/// </summary>
+template <>
+inline bool Resource<sf::Music>::finalize(sf::Music* object, ResourceData& data, ResourceDecode<sf::Music>& decoded)
+{
+	return object->openFromMemory(data.getData(), data.getSize());
+}
+
+/// <summary>
+/// Music isn't loaded without an audio device
+/// </summary>
+template <>
+inline bool Resource<sf::Music>::canLoad()
+{
+	return !isHeadless();
 }
 
 // ============================================================================
 
+/// <summary>
+/// Background load of a single resource
+/// </summary>
+template <typename T>
+class ResourceRequest : public LoadRequest
+{
+public:
+	ResourceRequest(NameId name, const sf::String& fname) :
+		LoadRequest		(fname),
+		mName			(name)
+	{ }
+
+protected:
+	bool decode() override
+	{
+		return Resource<T>::decode(mFileName, mData, mDecoded);
+	}
+
+	bool finish(bool decoded) override
+	{
+		return Resource<T>::finishRequest(mName, this, decoded);
+	}
+
+private:
+	friend class Resource<T>;
+
+	/// <summary>
+	/// Name of the resource being loaded
+	/// </summary>
+	NameId mName;
+
+	/// <summary>
+	/// File data, only left here if the resource wasn't created
+	/// </summary>
+	ResourceData mData;
+
+	/// <summary>
+	/// Decoded data
+	/// </summary>
+	ResourceDecode<T> mDecoded;
+};
+
+// ============================================================================
+
+/// <summary>
+/// Handle to a resource that may still be loading in the background (see Resource::requestLoad).
+/// Actions hold these so they can wait for their resources without stalling the frame.
+/// A handle created from only a name is deferred, its load starts when request() is called
+/// </summary>
+template <typename T>
+class LoadHandle
+{
+public:
+	LoadHandle() :
+		mIsRequested	(false)
+	{ }
+
+	explicit LoadHandle(NameId name) :
+		mName			(name),
+		mIsRequested	(false)
+	{ }
+
+	LoadHandle(NameId name, const std::shared_ptr<LoadRequest>& request) :
+		mName			(name),
+		mRequest		(request),
+		mIsRequested	(true)
+	{ }
+
+	/// <summary>
+	/// Start loading the resource if the handle is deferred. Does nothing if the load was already requested
+	/// </summary>
+	void request()
+	{
+		if (isValid() && !mIsRequested)
+			*this = Resource<T>::requestLoad(mName);
+	}
+
+	/// <summary>
+	/// Returns true if the handle refers to a resource
+	/// </summary>
+	/// <returns>Boolean</returns>
+	bool isValid() const
+	{
+		return mName != NameId();
+	}
+
+	/// <summary>
+	/// Returns true if the load has been requested
+	/// </summary>
+	/// <returns>Boolean</returns>
+	bool isRequested() const
+	{
+		return mIsRequested;
+	}
+
+	/// <summary>
+	/// Returns true once the load has finished, successfully or not.
+	/// Handles that don't refer to a resource are always done, deferred handles are never done
+	/// </summary>
+	/// <returns>Boolean</returns>
+	bool isDone() const
+	{
+		if (!isValid()) return true;
+
+		return mIsRequested && (!mRequest || mRequest->isDone());
+	}
+
+	/// <summary>
+	/// Get the resource. Returns NULL if it is still loading or failed to load.
+	/// A deferred handle loads the resource on the calling thread
+	/// </summary>
+	/// <returns>Pointer to resource</returns>
+	T* get() const
+	{
+		if (!isValid()) return 0;
+
+		if (!mIsRequested)
+			return Resource<T>::get(mName);
+
+		if (!isDone() || (mRequest && !mRequest->isLoaded()))
+			return 0;
+
+		return Resource<T>::get(mName);
+	}
+
+	/// <summary>
+	/// Block until the load is done, then get the resource
+	/// </summary>
+	/// <returns>Pointer to resource, or NULL if it failed to load</returns>
+	T* wait() const
+	{
+		if (mRequest)
+			ResourceLoader::wait(mRequest.get());
+
+		return get();
+	}
+
+	/// <summary>
+	/// Get the resource name
+	/// </summary>
+	/// <returns>Name</returns>
+	NameId getName() const
+	{
+		return mName;
+	}
+
+private:
+	/// <summary>
+	/// Name of the resource
+	/// </summary>
+	NameId mName;
+
+	/// <summary>
+	/// Background load, or null if the resource didn't need loading
+	/// </summary>
+	std::shared_ptr<LoadRequest> mRequest;
+
+	/// <summary>
+	/// True once the load has been requested
+	/// </summary>
+	bool mIsRequested;
+};
+
+// ============================================================================
+
 
 }
 
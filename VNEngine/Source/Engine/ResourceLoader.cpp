@@ -0,0 +1,246 @@
+#include <Engine/ResourceLoader.h>
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace vne;
+
+// ============================================================================
+
+namespace
+{
+/* Worker threads */
+std::vector<std::thread> gWorkers;
+
+/* Requests waiting for a worker. Requests taken by the main thread stay in the queue and are skipped */
+std::deque<std::shared_ptr<LoadRequest>> gQueue;
+
+/* Decoded requests waiting to be finished on the main thread */
+std::deque<std::shared_ptr<LoadRequest>> gDecoded;
+
+/* Number of requests that aren't done */
+std::atomic<Uint32> gNumPending(0);
+
+bool gIsStopping = false;
+
+std::mutex gMutex;
+
+/* Signals workers that there is work or that they should stop */
+std::condition_variable gWorkReady;
+
+/* Signals the main thread that a request was decoded */
+std::condition_variable gDecodeDone;
+}
+
+// ============================================================================
+// ============================================================================
+
+LoadRequest::LoadRequest(const sf::String& fname) :
+	mFileName		(fname),
+	mState			(Queued),
+	mIsDecoded		(false),
+	mIsLoaded		(false),
+	mIsPending		(false)
+{
+
+}
+
+LoadRequest::~LoadRequest()
+{
+
+}
+
+// ============================================================================
+
+bool LoadRequest::isDone() const
+{
+	return mState.load(std::memory_order_acquire) == Done;
+}
+
+bool LoadRequest::isLoaded() const
+{
+	return isDone() && mIsLoaded;
+}
+
+const sf::String& LoadRequest::getFileName() const
+{
+	return mFileName;
+}
+
+// ============================================================================
+// ============================================================================
+
+void ResourceLoader::start(Uint32 numThreads)
+{
+	if (!gWorkers.empty()) return;
+
+	gIsStopping = false;
+	for (Uint32 i = 0; i < numThreads; ++i)
+		gWorkers.push_back(std::thread(&ResourceLoader::workerMain));
+}
+
+void ResourceLoader::stop()
+{
+	{
+		std::lock_guard<std::mutex> lock(gMutex);
+		gIsStopping = true;
+	}
+	gWorkReady.notify_all();
+
+	for (Uint32 i = 0; i < gWorkers.size(); ++i)
+		gWorkers[i].join();
+	gWorkers.clear();
+
+	// Unfinished requests are no longer finished by update(), only by wait(), so they stop counting as pending
+	std::lock_guard<std::mutex> lock(gMutex);
+	for (Uint32 i = 0; i < gQueue.size(); ++i)
+		unpend(gQueue[i].get());
+	for (Uint32 i = 0; i < gDecoded.size(); ++i)
+		unpend(gDecoded[i].get());
+
+	gQueue.clear();
+	gDecoded.clear();
+}
+
+bool ResourceLoader::isRunning()
+{
+	return !gWorkers.empty();
+}
+
+// ============================================================================
+
+void ResourceLoader::submit(const std::shared_ptr<LoadRequest>& request)
+{
+	request->mIsPending = true;
+	++gNumPending;
+
+	{
+		std::lock_guard<std::mutex> lock(gMutex);
+		gQueue.push_back(request);
+	}
+	gWorkReady.notify_one();
+}
+
+// ============================================================================
+
+void ResourceLoader::workerMain()
+{
+	while (true)
+	{
+		std::shared_ptr<LoadRequest> request;
+
+		{
+			std::unique_lock<std::mutex> lock(gMutex);
+			gWorkReady.wait(lock, []() { return gIsStopping || !gQueue.empty(); });
+			if (gIsStopping) return;
+
+			request = gQueue.front();
+			gQueue.pop_front();
+		}
+
+		if (!decode(request.get())) continue;
+
+		// Publish the state and the list entry together, so a waiting main thread always finds the request in the list
+		{
+			std::lock_guard<std::mutex> lock(gMutex);
+			request->mState.store(LoadRequest::Decoded, std::memory_order_release);
+			gDecoded.push_back(request);
+		}
+		gDecodeDone.notify_all();
+	}
+}
+
+bool ResourceLoader::decode(LoadRequest* request)
+{
+	// Whichever thread moves the request out of the queued state decodes it
+	int expected = LoadRequest::Queued;
+	if (!request->mState.compare_exchange_strong(expected, LoadRequest::Decoding))
+		return false;
+
+	request->mIsDecoded = request->decode();
+	return true;
+}
+
+void ResourceLoader::finish(LoadRequest* request)
+{
+	request->mIsLoaded = request->finish(request->mIsDecoded);
+	request->mState.store(LoadRequest::Done, std::memory_order_release);
+	unpend(request);
+}
+
+void ResourceLoader::unpend(LoadRequest* request)
+{
+	if (request->mIsPending)
+	{
+		request->mIsPending = false;
+		--gNumPending;
+	}
+}
+
+// ============================================================================
+
+void ResourceLoader::update(float maxTime)
+{
+	sf::Clock clock;
+
+	while (true)
+	{
+		std::shared_ptr<LoadRequest> request;
+
+		{
+			std::lock_guard<std::mutex> lock(gMutex);
+			if (gDecoded.empty()) return;
+
+			request = gDecoded.front();
+			gDecoded.pop_front();
+		}
+
+		finish(request.get());
+
+		if (clock.getElapsedTime().asSeconds() >= maxTime)
+			return;
+	}
+}
+
+void ResourceLoader::wait(LoadRequest* request)
+{
+	if (request->isDone()) return;
+
+	// Decode on this thread if no worker has started the request
+	if (decode(request))
+	{
+		finish(request);
+		return;
+	}
+
+	// Keep the request alive while it is finished, the caller may only hold it through a resource entry
+	std::shared_ptr<LoadRequest> keep;
+
+	{
+		std::unique_lock<std::mutex> lock(gMutex);
+		gDecodeDone.wait(lock, [=]() { return request->mState.load(std::memory_order_acquire) != LoadRequest::Decoding; });
+
+		// Remove it from the decoded list, so update() doesn't finish it again
+		for (auto it = gDecoded.begin(); it != gDecoded.end(); ++it)
+		{
+			if (it->get() == request)
+			{
+				keep = *it;
+				gDecoded.erase(it);
+				break;
+			}
+		}
+	}
+
+	finish(request);
+}
+
+Uint32 ResourceLoader::getNumPending()
+{
+	return gNumPending;
+}
+
+// ============================================================================
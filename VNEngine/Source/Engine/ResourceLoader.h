@@ -0,0 +1,172 @@
+#ifndef RESOURCE_LOADER_H
+#define RESOURCE_LOADER_H
+
+#include <Core/DataTypes.h>
+
+#include <SFML/System.hpp>
+
+#include <atomic>
+#include <memory>
+
+namespace vne
+{
+
+// ============================================================================
+
+/// <summary>
+/// A single background load.
+/// The load is split into a decode step that runs on a worker thread (reading, decrypting, decompressing, decoding),
+/// and a finish step that runs on the main thread for the parts that need the GPU or audio device
+/// </summary>
+class LoadRequest
+{
+public:
+	LoadRequest(const sf::String& fname);
+	virtual ~LoadRequest();
+
+	/// <summary>
+	/// Returns true once the load has finished, successfully or not
+	/// </summary>
+	/// <returns>Boolean</returns>
+	bool isDone() const;
+
+	/// <summary>
+	/// Returns true if the load finished successfully
+	/// </summary>
+	/// <returns>Boolean</returns>
+	bool isLoaded() const;
+
+	/// <summary>
+	/// Get the file being loaded
+	/// </summary>
+	/// <returns>File name</returns>
+	const sf::String& getFileName() const;
+
+protected:
+	/// <summary>
+	/// Read and decode the file. Runs on a worker thread, or on the main thread if the main thread has to wait
+	/// </summary>
+	/// <returns>True if the file was decoded</returns>
+	virtual bool decode() = 0;
+
+	/// <summary>
+	/// Create the resource from the decoded data. Always runs on the main thread
+	/// </summary>
+	/// <param name="decoded">Result of decode()</param>
+	/// <returns>True if the resource was created</returns>
+	virtual bool finish(bool decoded) = 0;
+
+protected:
+	/// <summary>
+	/// File being loaded
+	/// </summary>
+	sf::String mFileName;
+
+private:
+	friend class ResourceLoader;
+
+	/// <summary>
+	/// Load progress
+	/// </summary>
+	enum State
+	{
+		Queued,
+		Decoding,
+		Decoded,
+		Done
+	};
+
+	/// <summary>
+	/// Current state, changed by both the workers and the main thread
+	/// </summary>
+	std::atomic<int> mState;
+
+	/// <summary>
+	/// Result of decode()
+	/// </summary>
+	bool mIsDecoded;
+
+	/// <summary>
+	/// Result of finish()
+	/// </summary>
+	bool mIsLoaded;
+
+	/// <summary>
+	/// True while the request is counted as pending
+	/// </summary>
+	bool mIsPending;
+};
+
+// ============================================================================
+
+/// <summary>
+/// Pool of worker threads that decode resources in the background.
+/// Decoded requests are finished on the main thread in update(), which the engine calls once a frame
+/// </summary>
+class ResourceLoader
+{
+public:
+	/// <summary>
+	/// Start the worker threads. Does nothing if the loader is already running
+	/// </summary>
+	/// <param name="numThreads">Number of worker threads</param>
+	static void start(Uint32 numThreads);
+
+	/// <summary>
+	/// Stop the worker threads.
+	/// Requests that haven't finished are no longer finished by update(), waiting on them loads them on the calling thread
+	/// </summary>
+	static void stop();
+
+	/// <summary>
+	/// Returns true if the worker threads are running
+	/// </summary>
+	/// <returns>Boolean</returns>
+	static bool isRunning();
+
+	/// <summary>
+	/// Queue a request to be decoded by a worker
+	/// </summary>
+	/// <param name="request">Request</param>
+	static void submit(const std::shared_ptr<LoadRequest>& request);
+
+	/// <summary>
+	/// Finish decoded requests on the main thread.
+	/// At least one request is finished per call, then requests are finished until the time limit is reached
+	/// </summary>
+	/// <param name="maxTime">Time limit in seconds</param>
+	static void update(float maxTime);
+
+	/// <summary>
+	/// Block the main thread until a request is done.
+	/// A request that no worker has started is decoded on the calling thread instead of waiting for one
+	/// </summary>
+	/// <param name="request">Request</param>
+	static void wait(LoadRequest* request);
+
+	/// <summary>
+	/// Get the number of requests that haven't been finished
+	/// </summary>
+	/// <returns>Number of requests</returns>
+	static Uint32 getNumPending();
+
+private:
+	/* Worker thread loop */
+	static void workerMain();
+
+	/* Decode a request if no other thread has started it, returns false if it was already taken.
+	   The request is left in the decoding state for the caller to publish */
+	static bool decode(LoadRequest* request);
+
+	/* Run the main thread part of a decoded request */
+	static void finish(LoadRequest* request);
+
+	/* Stop counting a request as pending, if it still is */
+	static void unpend(LoadRequest* request);
+};
+
+// ============================================================================
+
+}
+
+#endif
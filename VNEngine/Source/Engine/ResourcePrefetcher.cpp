@@ -0,0 +1,81 @@
+#include <Engine/ResourcePrefetcher.h>
+#include <Engine/Action.h>
+
+using namespace vne;
+
+// ============================================================================
+// ============================================================================
+
+ResourcePrefetcher::ResourcePrefetcher() :
+	mDistance		(8),
+	mNextIndex		(0),
+	mNumHits		(0),
+	mNumMisses		(0)
+{
+
+}
+
+// ============================================================================
+
+void ResourcePrefetcher::update(const ResourceVector<Action*>& actions, int index)
+{
+	// Actions before the current one have already run, and requesting a load twice does nothing,
+	// so only actions that enter the window are visited
+	Uint32 start = index < 0 ? 0 : (Uint32)index + 1;
+	if (mNextIndex < start)
+		mNextIndex = start;
+
+	Uint32 end = start + mDistance;
+	if (end > actions.size())
+		end = (Uint32)actions.size();
+
+	for (; mNextIndex < end; ++mNextIndex)
+		actions[mNextIndex]->prefetch();
+}
+
+void ResourcePrefetcher::onRun(Action* action)
+{
+	// Start the load now if the action wasn't prefetched
+	Uint32 numResources = action->prefetch();
+	if (!numResources) return;
+
+	if (action->isReady())
+		++mNumHits;
+	else
+		++mNumMisses;
+}
+
+void ResourcePrefetcher::reset()
+{
+	mNextIndex = 0;
+}
+
+// ============================================================================
+
+void ResourcePrefetcher::setDistance(Uint32 distance)
+{
+	mDistance = distance;
+}
+
+Uint32 ResourcePrefetcher::getDistance() const
+{
+	return mDistance;
+}
+
+Uint32 ResourcePrefetcher::getNumHits() const
+{
+	return mNumHits;
+}
+
+Uint32 ResourcePrefetcher::getNumMisses() const
+{
+	return mNumMisses;
+}
+
+void ResourcePrefetcher::resetStats()
+{
+	mNumHits = 0;
+	mNumMisses = 0;
+}
+
+// ============================================================================
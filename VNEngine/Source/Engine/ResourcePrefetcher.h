@@ -0,0 +1,98 @@
+#ifndef RESOURCE_PREFETCHER_H
+#define RESOURCE_PREFETCHER_H
+
+#include <Core/DataTypes.h>
+#include <Core/MemoryResource.h>
+
+namespace vne
+{
+
+// ============================================================================
+
+class Action;
+
+/// <summary>
+/// Starts background loads for the resources of upcoming scene actions, so they are resident by the time the actions run.
+/// Actions are prefetched whether or not their conditions will be met, conditions can change before the action is reached
+/// </summary>
+class ResourcePrefetcher
+{
+public:
+	ResourcePrefetcher();
+
+	/// <summary>
+	/// Start loads for the actions after the current action, up to the prefetch distance.
+	/// Children of action groups are prefetched along with their group
+	/// </summary>
+	/// <param name="actions">Scene action list</param>
+	/// <param name="index">Index of the current action</param>
+	void update(const ResourceVector<Action*>& actions, int index);
+
+	/// <summary>
+	/// Start loads for an action that is about to run, and count whether its resources were already loaded.
+	/// Actions that use no resources aren't counted
+	/// </summary>
+	/// <param name="action">Action</param>
+	void onRun(Action* action);
+
+	/// <summary>
+	/// Forget which actions were prefetched, should be called when the action list is cleared
+	/// </summary>
+	void reset();
+
+	/// <summary>
+	/// Set the number of actions after the current action to prefetch. Set to 0 to only load resources when actions run
+	/// </summary>
+	/// <param name="distance">Number of actions</param>
+	void setDistance(Uint32 distance);
+
+	/// <summary>
+	/// Get the number of actions after the current action that are prefetched
+	/// </summary>
+	/// <returns>Number of actions</returns>
+	Uint32 getDistance() const;
+
+	/// <summary>
+	/// Get the number of actions that found their resources loaded when they ran
+	/// </summary>
+	/// <returns>Number of hits</returns>
+	Uint32 getNumHits() const;
+
+	/// <summary>
+	/// Get the number of actions that had to wait for their resources when they ran
+	/// </summary>
+	/// <returns>Number of misses</returns>
+	Uint32 getNumMisses() const;
+
+	/// <summary>
+	/// Reset the hit and miss counts
+	/// </summary>
+	void resetStats();
+
+private:
+	/// <summary>
+	/// Number of actions to look ahead
+	/// </summary>
+	Uint32 mDistance;
+
+	/// <summary>
+	/// Index of the first action that hasn't been prefetched
+	/// </summary>
+	Uint32 mNextIndex;
+
+	/// <summary>
+	/// Number of actions with resources loaded when they ran
+	/// </summary>
+	Uint32 mNumHits;
+
+	/// <summary>
+	/// Number of actions that waited for resources
+	/// </summary>
+	Uint32 mNumMisses;
+};
+
+// ============================================================================
+
+}
+
+#endif
@@ -2,6 +2,8 @@
 #include <Engine/Engine.h>
 #include <Engine/Resource.h>
 
+#include <Core/FrameProfiler.h>
+
 #include <SFML/Graphics.hpp>
 
 #include <UI/Button.h>
@@ -13,7 +15,15 @@ using namespace vne;
 
 Scene::Scene(Engine* engine) :
 	mEngine			(engine),
-	mActionIndex	(-1)
+	mMaxCachedPages	(0xFFFFFFFF),
+	mMemoryMode		(Pooled),
+	mArenaResource	(&mArena),
+	mMemoryResource	(&mPoolResource),
+	mPoolReserve	(0),
+	mActions		(&mMemoryResource),
+	mActionIndex	(-1),
+	mAnimations		(&mMemoryResource),
+	mNumActionsRun	(0)
 {
 
 }
@@ -21,8 +31,11 @@ Scene::Scene(Engine* engine) :
 Scene::~Scene()
 {
 	// Remove all object pools
-	for (auto it = mObjectPools.begin(); it != mObjectPools.end(); ++it)
-		delete it->second;
+	for (Uint32 i = 0; i < mObjectPools.size(); ++i)
+		delete mObjectPools[i];
+
+	// Destroy arena objects while the container memory resources still exist
+	mArena.free();
 }
 
 // ============================================================================
@@ -39,14 +52,135 @@ void Scene::addAnimation(I_Animation* anim)
 	mAnimations.push_back(anim);
 }
 
+void Scene::runAction(Action* action)
+{
+	// Only the first attempt is counted, a waiting action is run again once it is ready
+	if (!action->isWaiting())
+		mPrefetcher.onRun(action);
+
+	// Wait for resources that are still loading, without blocking the frame
+	if (!action->isReady())
+	{
+		action->setWaiting(true);
+		return;
+	}
+
+	action->setWaiting(false);
+	++mNumActionsRun;
+	action->run();
+}
+
+void Scene::updateAction(Action* action, float dt)
+{
+	if (action->isWaiting())
+	{
+		if (!action->isReady()) return;
+
+		runAction(action);
+		return;
+	}
+
+	action->update(dt);
+}
+
+// ============================================================================
+
+bool Scene::isFinished() const
+{
+	return mActionIndex >= (int)mActions.size() && mAnimations.empty();
+}
+
+Uint32 Scene::getNumActionsRun() const
+{
+	return mNumActionsRun;
+}
+
+ResourcePrefetcher& Scene::getPrefetcher()
+{
+	return mPrefetcher;
+}
+
+// ============================================================================
+
+void Scene::setMaxCachedPages(Uint32 pages)
+{
+	mMaxCachedPages = pages;
+
+	for (Uint32 i = 0; i < mObjectPools.size(); ++i)
+	{
+		if (mObjectPools[i])
+			mObjectPools[i]->setMaxCachedPages(pages);
+	}
+}
+
+void Scene::setMemoryMode(MemoryMode mode)
+{
+	mMemoryMode = mode;
+
+	// Containers follow the objects
+	mMemoryResource.setTarget(mode == Linear ? (MemoryResource*)&mArenaResource : &mPoolResource);
+}
+
+MemoryResource* Scene::getMemoryResource()
+{
+	return &mMemoryResource;
+}
+
+Condition* Scene::compileCondition(const char* expr)
+{
+	Condition* condition = alloc<Condition>(getMemoryResource());
+	condition->compile(expr, &mEngine->getVariables());
+	return condition;
+}
+
+void Scene::setArenaSize(Uint32 size)
+{
+	mArena.setBlockSize(size);
+}
+
+// ============================================================================
+
+void Scene::prewarmPools(const PoolProfile::Counts* counts)
+{
+	mPoolReserve = counts;
+
+	for (Uint32 i = 0; i < mObjectPools.size(); ++i)
+	{
+		if (mObjectPools[i])
+			reservePool(mObjectPools[i]);
+	}
+}
+
+#ifdef VNE_POOL_STATS
+void Scene::recordPoolUsage(PoolProfile& profile, const std::string& name) const
+{
+	for (Uint32 i = 0; i < mObjectPools.size(); ++i)
+	{
+		if (mObjectPools[i])
+			profile.record(name, mObjectPools[i]->getTypeName(), (Uint32)mObjectPools[i]->getStats().mPeakLive);
+	}
+}
+#endif
+
+void Scene::reservePool(IObjectPool* pool)
+{
+	if (!mPoolReserve) return;
+
+	auto it = mPoolReserve->find(pool->getTypeName());
+	if (it != mPoolReserve->end())
+		pool->reserve(it->second);
+}
+
 // ============================================================================
 
 void Scene::update(float dt)
 {
 	if (mActions.size())
 	{
+		PROFILE_SCOPE(SceneUpdate);
+
 		if (mActionIndex >= 0 && mActionIndex < mActions.size())
-			mActions[mActionIndex]->update(dt);
+			updateAction(mActions[mActionIndex], dt);
 
 		// If the current action is completed or the index is negative
 		if (mActionIndex < 0 || (mActionIndex < mActions.size() && mActions[mActionIndex]->isComplete()))
@@ -57,11 +191,15 @@ void Scene::update(float dt)
 
 			if (mActionIndex < mActions.size())
 				// Run action
-				mActions[mActionIndex]->run();
+				runAction(mActions[mActionIndex]);
 		}
+
+		// Start loading resources for the next actions
+		mPrefetcher.update(mActions, mActionIndex);
 	}
 
 	// Update animations
+	PROFILE_SCOPE(AnimationUpdate);
 	for (Uint32 i = 0; i < mAnimations.size(); ++i)
 	{
 		// Update animation
@@ -79,12 +217,21 @@ void Scene::update(float dt)
 
 void Scene::cleanup()
 {
-	// Remove all objects from object pools
-	for (auto it = mObjectPools.begin(); it != mObjectPools.end(); ++it)
-		it->second->free();
+	// Release action and animation lists first, their memory may be in the arena
+	ResourceVector<Action*>(&mMemoryResource).swap(mActions);
+	ResourceVector<I_Animation*>(&mMemoryResource).swap(mAnimations);
+	mActionIndex = -1;
+	mPrefetcher.reset();
+
+	// Remove all objects from object pools, but keep their pages for the next time the scene is used
+	for (Uint32 i = 0; i < mObjectPools.size(); ++i)
+	{
+		if (mObjectPools[i])
+			mObjectPools[i]->reset();
+	}
 
-	// Clear actions list
-	mActions.clear();
+	// Destroy arena objects and rewind the arena
+	mArena.reset();
 }
 
 // ============================================================================
@@ -205,7 +352,7 @@ void MainMenuScene::init()
 	mUI.init();
 
 	// Get view size
-	const sf::Vector2f& viewSize = mEngine->getWindow().getView().getSize();
+	const sf::Vector2f& viewSize = mEngine->getView().getSize();
 
 	float x = viewSize.x * 0.5f;
 	float y = 400.0f;
@@ -292,7 +439,7 @@ void MainMenuScene::onUpdate(float dt)
 
 void MainMenuScene::render()
 {
-	sf::RenderWindow& target = mEngine->getWindow();
+	sf::RenderTarget& target = mEngine->getRenderTarget();
 
 	target.draw(mUI);
 }
@@ -311,7 +458,8 @@ NovelScene::NovelScene(Engine* engine) :
 	Scene		(engine),
 	mUI			(engine)
 {
-
+	// Script objects all live as long as the scene
+	setMemoryMode(Linear);
 }
 
 NovelScene::~NovelScene()
@@ -326,7 +474,7 @@ void NovelScene::init()
 	mUI.init();
 
 	// Get view size
-	const sf::Vector2f& viewSize = mEngine->getWindow().getView().getSize();
+	const sf::Vector2f& viewSize = mEngine->getView().getSize();
 
 	mBackground = mUI.create<ImageBox>("Background");
 	mBackground->setSize(viewSize);
@@ -455,7 +603,7 @@ std::stack<ActionGroup*>& NovelScene::getActionGroups()
 
 void NovelScene::startGroup(bool parallel, const std::function<bool()>& condition)
 {
-	ActionGroup* action = alloc<ActionGroup>();
+	ActionGroup* action = alloc<ActionGroup>(getMemoryResource());
 	action->setParallel(parallel);
 	action->setCondition(condition);
 
@@ -466,6 +614,12 @@ void NovelScene::startGroup(bool parallel, const std::function<bool()>& conditio
 	Scene::addAction(mActionGroups.top());
 }
 
+void NovelScene::startGroup(bool parallel, const char* condition)
+{
+	startGroup(parallel);
+	mActionGroups.top()->setCondition(compileCondition(condition));
+}
+
 void NovelScene::endGroup()
 {
 	// Pop
@@ -483,7 +637,11 @@ void NovelScene::narrate(const sf::String& dialogue)
 
 void NovelScene::background(const sf::String& bgName, Transition effect, float duration)
 {
-	background(Resource<sf::Texture>::get(bgName), effect, duration);
+	BackgroundAction* action = alloc<BackgroundAction>();
+	action->setTexture(LoadHandle<sf::Texture>(bgName));
+	action->setTransition(effect);
+	action->setDuration(duration);
+	addAction(action);
 }
 
 void NovelScene::background(sf::Texture* texture, Transition effect, float duration)
@@ -497,7 +655,13 @@ void NovelScene::background(sf::Texture* texture, Transition effect, float durat
 
 void NovelScene::start(const sf::String& music, float volume, Transition effect, float duration)
 {
-	start(Resource<sf::Music>::get(music), volume, effect, duration);
+	MusicAction* action = alloc<MusicAction>();
+	action->setMusic(LoadHandle<sf::Music>(music));
+	action->setVolume(volume);
+	action->setMode(MusicAction::Start);
+	action->setTransition(effect);
+	action->setDuration(duration);
+	addAction(action);
 }
 
 void NovelScene::start(sf::Music* music, float volume, Transition effect, float duration)
@@ -513,7 +677,12 @@ void NovelScene::start(sf::Music* music, float volume, Transition effect, float
 
 void NovelScene::stop(const sf::String& music, Transition effect, float duration)
 {
-	stop(Resource<sf::Music>::get(music), effect, duration);
+	MusicAction* action = alloc<MusicAction>();
+	action->setMusic(LoadHandle<sf::Music>(music));
+	action->setMode(MusicAction::Stop);
+	action->setTransition(effect);
+	action->setDuration(duration);
+	addAction(action);
 }
 
 void NovelScene::stop(sf::Music* music, Transition effect, float duration)
@@ -528,7 +697,10 @@ void NovelScene::stop(sf::Music* music, Transition effect, float duration)
 
 void NovelScene::sound(const sf::String& name, float volume)
 {
-	sound(Resource<sf::SoundBuffer>::get(name), volume);
+	SoundAction* action = alloc<SoundAction>();
+	action->setBuffer(LoadHandle<sf::SoundBuffer>(name));
+	action->setVolume(volume);
+	addAction(action);
 }
 
 void NovelScene::sound(sf::SoundBuffer* buffer, float volume)
@@ -543,7 +715,7 @@ void NovelScene::sound(sf::SoundBuffer* buffer, float volume)
 
 void NovelScene::render()
 {
-	sf::RenderWindow& target = mEngine->getWindow();
+	sf::RenderTarget& target = mEngine->getRenderTarget();
 
 	target.draw(mUI);
 }
@@ -1,8 +1,15 @@
 #ifndef SCENE_H
 #define SCENE_H
 
+#include <Core/ObjectPool.h>
+#include <Core/LinearArena.h>
+#include <Core/MemoryResource.h>
+#include <Core/PoolProfile.h>
+#include <Core/TypeSlot.h>
+
 #include <Engine/Action.h>
 #include <Engine/Animation.h>
+#include <Engine/ResourcePrefetcher.h>
 
 #include <UI/UI.h>
 #include <UI/UIContainer.h>
@@ -14,8 +21,6 @@
 
 #include <stack>
 #include <unordered_map>
-#include <typeinfo>
-#include <typeindex>
 
 namespace vne
 {
@@ -31,6 +36,24 @@ class Engine;
 /// </summary>
 class Scene
 {
+public:
+	/// <summary>
+	/// Determines where objects allocated with Scene::alloc are stored
+	/// </summary>
+	enum MemoryMode
+	{
+		/// <summary>
+		/// Each type gets its own object pool. Objects can be freed individually
+		/// </summary>
+		Pooled,
+
+		/// <summary>
+		/// All objects are placed in a single linear arena. Objects can't be freed individually,
+		/// they all live until the scene is cleaned up
+		/// </summary>
+		Linear
+	};
+
 public:
 	Scene(Engine* engine);
 	virtual ~Scene();
@@ -77,6 +100,40 @@ public:
 	/// </summary>
 	void addAnimation(I_Animation* anim);
 
+	/// <summary>
+	/// Run an action and count it in the number of actions run.
+	/// If the action isn't ready, it is marked as waiting and runs in updateAction() once it is ready
+	/// </summary>
+	/// <param name="action">Action</param>
+	void runAction(Action* action);
+
+	/// <summary>
+	/// Update an action that has been started, or run it if it was waiting and is now ready
+	/// </summary>
+	/// <param name="action">Action</param>
+	/// <param name="dt">Time elapsed since last frame</param>
+	void updateAction(Action* action, float dt);
+
+	/// <summary>
+	/// Returns true once every action has run and all animations have finished
+	/// </summary>
+	/// <returns>Boolean</returns>
+	bool isFinished() const;
+
+	/// <summary>
+	/// Get the number of actions that have run in this scene, including actions inside groups.
+	/// The count is kept across scene runs
+	/// </summary>
+	/// <returns>Number of actions run</returns>
+	Uint32 getNumActionsRun() const;
+
+	/// <summary>
+	/// Get the prefetcher that loads resources for upcoming actions.
+	/// Its hit and miss counts are kept across scene runs
+	/// </summary>
+	/// <returns>Resource prefetcher</returns>
+	ResourcePrefetcher& getPrefetcher();
+
 
 	/// <summary>
 	/// Allocate an object from the scene's managed memory
@@ -84,28 +141,101 @@ public:
 	template <typename T, typename... Args>
 	T* alloc(Args&&... args)
 	{
-		std::type_index typeID = typeid(T);
+		if (mMemoryMode == Linear)
+			return mArena.create<T>(std::forward<Args>(args)...);
 
-		IObjectPool*& pool = mObjectPools[typeID];
+		// Get pool from the type's slot
+		Uint32 slot = TypeSlot::get<T>();
+		if (slot >= mObjectPools.size())
+			mObjectPools.resize(slot + 1, 0);
+
+		IObjectPool*& pool = mObjectPools[slot];
 		if (!pool)
+		{
 			pool = new ObjectPool<T>();
+			pool->setMaxCachedPages(mMaxCachedPages);
+			reservePool(pool);
+		}
 
 		return ((ObjectPool<T>*)pool)->create(std::forward<Args>(args)...);
 	}
 
 	/// <summary>
-	/// Free an object that was allocated with the scene's managed memory
+	/// Free an object that was allocated with the scene's managed memory.
+	/// This does nothing in linear memory mode, the object is destroyed when the scene is cleaned up
 	/// </summary>
 	template <typename T>
 	void free(T* ptr)
 	{
-		std::type_index typeID = typeid(T);
+		if (mMemoryMode == Linear) return;
 
-		void*& pool = mObjectPools[typeID];
-		if (pool)
-			((ObjectPool<T>*)pool)->free(ptr);
+		Uint32 slot = TypeSlot::get<T>();
+		if (slot < mObjectPools.size() && mObjectPools[slot])
+			((ObjectPool<T>*)mObjectPools[slot])->free(ptr);
 	}
 
+	/// <summary>
+	/// Set the max number of pages each of the scene's object pools keeps after cleanup.
+	/// Kept pages are reused the next time the scene is initialized
+	/// </summary>
+	/// <param name="pages">Max number of pages per pool</param>
+	void setMaxCachedPages(Uint32 pages);
+
+	/// <summary>
+	/// Set where objects allocated with Scene::alloc are stored.
+	/// This should be set before any objects are allocated
+	/// </summary>
+	/// <param name="mode">Memory mode</param>
+	void setMemoryMode(MemoryMode mode);
+
+	/// <summary>
+	/// Get the memory resource used for the scene's containers.
+	/// It draws from the scene's arena in linear memory mode, and from size class pools otherwise.
+	/// Memory from it is only valid until the scene is cleaned up
+	/// </summary>
+	/// <returns>Memory resource</returns>
+	MemoryResource* getMemoryResource();
+
+	/// <summary>
+	/// Compile a condition expression that reads the engine's game variables (i.e. "points >= 10 && !met_bob").
+	/// The condition is allocated with the scene's managed memory, so it lives until the scene is cleaned up.
+	/// If the expression has an error, the condition is always false
+	/// </summary>
+	/// <param name="expr">Condition expression</param>
+	/// <returns>Compiled condition</returns>
+	Condition* compileCondition(const char* expr);
+
+	/// <summary>
+	/// Set the starting size of the linear arena in bytes.
+	/// The arena grows to fit all of the scene's objects the first time the scene runs
+	/// </summary>
+	/// <param name="size">Size in bytes</param>
+	void setArenaSize(Uint32 size);
+
+	/// <summary>
+	/// Reserve pool pages using the peak object counts recorded in a previous run.
+	/// Pools that don't exist yet are reserved when they are created
+	/// </summary>
+	/// <param name="counts">Peak object counts of this scene's pools, or null to stop reserving</param>
+	void prewarmPools(const PoolProfile::Counts* counts);
+
+#ifdef VNE_POOL_STATS
+	/// <summary>
+	/// Record the peak object count of each of the scene's pools.
+	/// Should be called before the scene is cleaned up
+	/// </summary>
+	/// <param name="profile">Profile to record to</param>
+	/// <param name="name">Name of the scene</param>
+	void recordPoolUsage(PoolProfile& profile, const std::string& name) const;
+#endif
+
+protected:
+	/// <summary>
+	/// Reserve pages for a pool if it has a recorded peak count
+	/// </summary>
+	/// <param name="pool">Object pool</param>
+	void reservePool(IObjectPool* pool);
+
 protected:
 	/// <summary>
 	/// Access to main engine
@@ -113,14 +243,49 @@ protected:
 	Engine* mEngine;
 
 	/// <summary>
-	/// Map of object pool for various types
+	/// Object pools for various types, indexed by type slot
+	/// </summary>
+	std::vector<IObjectPool*> mObjectPools;
+
+	/// <summary>
+	/// Max number of pages each object pool keeps after cleanup
+	/// </summary>
+	Uint32 mMaxCachedPages;
+
+	/// <summary>
+	/// Arena used in linear memory mode
+	/// </summary>
+	LinearArena mArena;
+
+	/// <summary>
+	/// Where allocated objects are stored
+	/// </summary>
+	MemoryMode mMemoryMode;
+
+	/// <summary>
+	/// Container memory in pooled memory mode, pages are kept across scene runs
+	/// </summary>
+	PoolResource mPoolResource;
+
+	/// <summary>
+	/// Container memory in linear memory mode
+	/// </summary>
+	ArenaResource mArenaResource;
+
+	/// <summary>
+	/// Forwards to the container memory resource of the current memory mode
+	/// </summary>
+	ProxyResource mMemoryResource;
+
+	/// <summary>
+	/// Recorded peak object counts used to reserve pool pages
 	/// </summary>
-	std::unordered_map<std::type_index, IObjectPool*> mObjectPools;
+	const PoolProfile::Counts* mPoolReserve;
 
 	/// <summary>
 	/// List of actions
 	/// </summary>
-	std::vector<Action*> mActions;
+	ResourceVector<Action*> mActions;
 
 	/// <summary>
 	/// Index of current action
@@ -130,7 +295,17 @@ protected:
 	/// <summary>
 	/// List of animations
 	/// </summary>
-	std::vector<I_Animation*> mAnimations;
+	ResourceVector<I_Animation*> mAnimations;
+
+	/// <summary>
+	/// Number of actions run
+	/// </summary>
+	Uint32 mNumActionsRun;
+
+	/// <summary>
+	/// Loads resources for upcoming actions
+	/// </summary>
+	ResourcePrefetcher mPrefetcher;
 };
 
 // ============================================================================
@@ -402,6 +577,13 @@ public:
 	/// </summary>
 	void startGroup(bool parallel = false, const std::function<bool()>& condition = std::function<bool()>());
 
+	/// <summary>
+	/// Start an action group that only runs if a condition expression is true (see Scene::compileCondition)
+	/// </summary>
+	/// <param name="parallel">Run the group's actions in parallel</param>
+	/// <param name="condition">Condition expression</param>
+	void startGroup(bool parallel, const char* condition);
+
 	/// <summary>
 	/// End the last action group (that was started using startGroup).
 	/// After this, any actions created by the convenience functions will be added to
@@ -428,7 +610,7 @@ public:
 
 	/// <summary>
 	/// Convenience function that adds a background transition action.
-	/// The default transition effect is None.
+	/// The default transition effect is None. The texture is loaded in the background when the action is near
 	/// </summary>
 	/// <param name="bgName">Name of the background image</param>
 	/// <param name="effect">Transition effect</param>
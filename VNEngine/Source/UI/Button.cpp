@@ -65,8 +65,8 @@ void Button::update(float dt)
 		mBody.setOrigin(mOrigin * mSize);
 
 		float charSize = (float)mLabel.getCharacterSize();
-		const sf::FloatRect& xBounds =
-			mLabel.getFont()->getGlyph(
+		sf::FloatRect xBounds =
+			mLabel.getGlyph(
 				L'X',
 				mLabel.getCharacterSize(),
 				mLabel.getStyle() & sf::Text::Bold
@@ -128,7 +128,7 @@ void Button::onInit(UI* ui)
 		mLabel.setFont(*ui->getDefaultFont());
 
 	// Set view
-	mLabel.setView(&mEngine->getWindow().getView());
+	mLabel.setView(&mEngine->getView());
 }
 
 void Button::onMouseEnter(const sf::Event& e)
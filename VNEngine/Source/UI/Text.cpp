@@ -2,6 +2,8 @@
 
 #include <Core/Math.h>
 
+#include <Engine/Resource.h>
+
 using namespace vne;
 
 // ============================================================================
@@ -19,7 +21,8 @@ void Text::setCharacterSize(Uint32 size)
 {
 	mTargetSize = size;
 
-	if (mView)
+	// There is no desktop in headless mode
+	if (mView && !isHeadless())
 	{
 		// Get current desktop video mode
 		sf::VideoMode mode = sf::VideoMode::getDesktopMode();
@@ -66,4 +69,21 @@ void Text::setView(const sf::View* view)
 	setCharacterSize(mTargetSize);
 }
 
+// ============================================================================
+
+sf::Glyph Text::getGlyph(Uint32 c, Uint32 characterSize, bool bold, float outlineThickness) const
+{
+	const sf::Font* font = getFont();
+	if (font)
+		return font->getGlyph(c, characterSize, bold, outlineThickness);
+
+	// Estimate an average glyph
+	float size = (float)characterSize;
+	sf::Glyph glyph;
+	glyph.advance = c == L'\n' ? 0.0f : 0.5f * size + 2.0f * outlineThickness;
+	glyph.bounds = sf::FloatRect(0.0f, -0.7f * size, 0.5f * size, 0.7f * size);
+
+	return glyph;
+}
+
 // ============================================================================
\ No newline at end of file
@@ -40,6 +40,17 @@ public:
 	/// <param name="view">View pointer</param>
 	void setView(const sf::View* view);
 
+	/// <summary>
+	/// Get a glyph from the current font.
+	/// If no font is set (i.e. in headless mode), the glyph metrics are estimated from the character size
+	/// </summary>
+	/// <param name="c">Character</param>
+	/// <param name="characterSize">Character size</param>
+	/// <param name="bold">Bold flag</param>
+	/// <param name="outlineThickness">Outline thickness</param>
+	/// <returns>Glyph</returns>
+	sf::Glyph getGlyph(Uint32 c, Uint32 characterSize, bool bold, float outlineThickness = 0.0f) const;
+
 private:
 	/// <summary>
 	/// Active view used to scale character size
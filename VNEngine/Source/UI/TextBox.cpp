@@ -4,6 +4,7 @@
 #include <Core/Math.h>
 
 #include <Engine/Engine.h>
+#include <Engine/Resource.h>
 
 using namespace vne;
 
@@ -31,6 +32,9 @@ void TextBox::setString(const sf::String& str)
 
 void TextBox::setFont(const sf::Font* font)
 {
+	// Text uses estimated metrics in headless mode
+	if (isHeadless()) return;
+
 	if (font != mText.getFont() && mText.getString().getSize())
 	{
 		mText.setFont(*font);
@@ -146,7 +150,6 @@ void TextBox::applyString(sf::String str)
 	// Add newlines if word wrap is enabled
 	if (mWordWrap > 0.0f)
 	{
-		const sf::Font* font = mText.getFont();
 		Uint32 characterSize = mText.getCharacterSize();
 		bool bold = mText.getStyle() & sf::Text::Bold;
 		float outlineThickness = mText.getOutlineThickness();
@@ -158,7 +161,7 @@ void TextBox::applyString(sf::String str)
 		for (Uint32 i = 0; i < str.getSize(); ++i)
 		{
 			Uint32 c = str[i];
-			const sf::Glyph& glyph = font->getGlyph(c, characterSize, bold, outlineThickness);
+			sf::Glyph glyph = mText.getGlyph(c, characterSize, bold, outlineThickness);
 
 			x += glyph.advance * scale;
 
@@ -206,7 +209,6 @@ void TextBox::applyString(sf::String str)
 	else
 	{
 		// If word wrap is off, go through string and search for new lines
-		const sf::Font* font = mText.getFont();
 		Uint32 characterSize = mText.getCharacterSize();
 		bool bold = mText.getStyle() & sf::Text::Bold;
 		float outlineThickness = mText.getOutlineThickness();
@@ -218,7 +220,7 @@ void TextBox::applyString(sf::String str)
 		for (Uint32 i = 0; i < str.getSize(); ++i)
 		{
 			Uint32 c = str[i];
-			const sf::Glyph& glyph = font->getGlyph(c, characterSize, bold, outlineThickness);
+			sf::Glyph glyph = mText.getGlyph(c, characterSize, bold, outlineThickness);
 
 			x += glyph.advance * scale;
 
@@ -280,7 +282,7 @@ void TextBox::onInit(UI* ui)
 {
 	if (ui->getDefaultFont())
 		mText.setFont(*ui->getDefaultFont());
-	mText.setView(&mEngine->getWindow().getView());
+	mText.setView(&mEngine->getView());
 }
 
 // ============================================================================
@@ -5,6 +5,7 @@
 #include <Core/Math.h>
 
 #include <Engine/Engine.h>
+#include <Engine/Resource.h>
 #include <Engine/Cursor.h>
 
 using namespace vne;
@@ -104,8 +105,8 @@ void TextInput::update(float dt)
 		mBody.setOrigin(mOrigin * mSize);
 
 		float charSize = (float)mText.getCharacterSize();
-		const sf::FloatRect& xBounds =
-			mText.getFont()->getGlyph(
+		sf::FloatRect xBounds =
+			mText.getGlyph(
 				L'X',
 				mText.getCharacterSize(),
 				mText.getStyle() & sf::Text::Bold
@@ -174,7 +175,7 @@ void TextInput::onInit(UI* ui)
 {
 	if (ui->getDefaultFont())
 		mText.setFont(*ui->getDefaultFont());
-	mText.setView(&mEngine->getWindow().getView());
+	mText.setView(&mEngine->getView());
 
 	mTextCursor = &ui->getTextCursor();
 	mTextHighlight = &ui->getTextHighlight();
@@ -210,7 +211,6 @@ bool TextInput::onMousePress(const sf::Event& e)
 	p.x -= mTextOffset;
 
 	const sf::String& textStr = mText.getString();
-	const sf::Font* font = mText.getFont();
 	Uint32 charSize = mText.getCharacterSize();
 	bool isBold = mText.getStyle() & sf::Text::Bold;
 
@@ -220,7 +220,7 @@ bool TextInput::onMousePress(const sf::Event& e)
 	Uint32 i;
 	for (i = 0; i < textStr.getSize(); ++i)
 	{
-		float advance = font->getGlyph(textStr[i], charSize, isBold).advance;
+		float advance = mText.getGlyph(textStr[i], charSize, isBold).advance;
 		float localPos = p.x - charPos;
 
 		// If this position is correct, break
@@ -230,8 +230,10 @@ bool TextInput::onMousePress(const sf::Event& e)
 	}
 
 	// Select if shift is held
-	if (sf::Keyboard::isKeyPressed(sf::Keyboard::LShift) ||
-		sf::Keyboard::isKeyPressed(sf::Keyboard::RShift))
+	// Keyboard state can't be read without a display
+	if (!isHeadless() &&
+		(sf::Keyboard::isKeyPressed(sf::Keyboard::LShift) ||
+		sf::Keyboard::isKeyPressed(sf::Keyboard::RShift)))
 	{
 		mSelectIndex = mCursorIndex;
 		mSelectPos = mCursorPos;
@@ -253,7 +255,6 @@ bool TextInput::onMouseMove(const sf::Event& e, const sf::Vector2f& p)
 	if (mIsMousePressed)
 	{
 		const sf::String& textStr = mText.getString();
-		const sf::Font* font = mText.getFont();
 		Uint32 charSize = mText.getCharacterSize();
 		bool isBold = mText.getStyle() & sf::Text::Bold;
 
@@ -263,7 +264,7 @@ bool TextInput::onMouseMove(const sf::Event& e, const sf::Vector2f& p)
 		Uint32 i;
 		for (i = 0; i < textStr.getSize(); ++i)
 		{
-			float advance = font->getGlyph(textStr[i], charSize, isBold).advance;
+			float advance = mText.getGlyph(textStr[i], charSize, isBold).advance;
 			float localPos = p.x - charPos;
 
 			// If this position is correct, break
@@ -511,14 +512,13 @@ void TextInput::onTextEntered(const sf::Event& e)
 float TextInput::getCharPos(Uint32 index)
 {
 	const sf::String& textStr = mText.getString();
-	const sf::Font* font = mText.getFont();
 	Uint32 charSize = mText.getCharacterSize();
 	bool isBold = mText.getStyle() & sf::Text::Bold;
 
 	float charPos = 0.0f;
 
 	for (Uint32 i = 0; i < index; ++i)
-		charPos += font->getGlyph(textStr[i], charSize, isBold).advance;
+		charPos += mText.getGlyph(textStr[i], charSize, isBold).advance;
 
 	return charPos;
 }
@@ -2,9 +2,11 @@
 #include <UI/UIContainer.h>
 #include <UI/Button.h>
 
+#include <Core/FrameProfiler.h>
 #include <Core/Math.h>
 
 #include <Engine/Engine.h>
+#include <Engine/Resource.h>
 
 #include <SFML/OpenGL.hpp>
 
@@ -41,7 +43,7 @@ UI::~UI()
 
 void UI::init()
 {
-	mRootElement->setSize(mEngine->getWindow().getView().getSize());
+	mRootElement->setSize(mEngine->getView().getSize());
 }
 
 // ============================================================================
@@ -63,6 +65,9 @@ void UI::setDefaultFont(sf::Font* font)
 
 sf::Font* UI::getDefaultFont()
 {
+	// Fonts need a context to render glyphs, so text uses estimated metrics in headless mode
+	if (isHeadless()) return 0;
+
 	if (!mDefaultFont)
 		mDefaultFont = mEngine->getDefaultFont();
 
@@ -156,7 +161,7 @@ bool UI::relayMouseEvent(UIElement* element, const sf::Event& e)
 	// Make sure it is also inside clipping area if enabled
 	if (element->isClipEnabled())
 	{
-		sf::Vector2f coordSpace = mEngine->getWindow().mapPixelToCoords(sf::Vector2i(e.mouseMove.x, e.mouseMove.y));
+		sf::Vector2f coordSpace = mEngine->mapPixelToCoords(sf::Vector2i(e.mouseMove.x, e.mouseMove.y));
 		inside &= element->getClipRegion().contains(coordSpace);
 	}
 
@@ -397,8 +402,10 @@ void UI::updateElement(UIElement* element, float dt)
 
 void UI::update(float dt)
 {
+	PROFILE_SCOPE(UIUpdate);
+
 	// Make sure root element size matches view size
-	const sf::Vector2f& viewSize = mEngine->getWindow().getView().getSize();
+	const sf::Vector2f& viewSize = mEngine->getView().getSize();
 	if (mRootElement->getSize() != viewSize)
 		mRootElement->setSize(viewSize);
 
@@ -409,8 +416,9 @@ void UI::update(float dt)
 
 void UI::drawElement(UIElement* element, sf::RenderTarget& target, const sf::RenderStates& states) const
 {
-	// Start clipping if this element has clipping enabled, but not parent
-	bool clipping = element->isClipEnabled() && (!element->getParent() || !element->getParent()->isClipEnabled());
+	// Start clipping if this element has clipping enabled, but not parent.
+	// Clipping uses OpenGL directly, so it is skipped in headless mode
+	bool clipping = element->isClipEnabled() && (!element->getParent() || !element->getParent()->isClipEnabled()) && !isHeadless();
 
 	// Handle region mode
 	if (clipping && element->getClipMode() == ClipMode::Region)
@@ -486,6 +494,8 @@ void UI::drawElement(UIElement* element, sf::RenderTarget& target, const sf::Ren
 
 void UI::draw(sf::RenderTarget& target, sf::RenderStates states) const
 {
+	PROFILE_SCOPE(UIDraw);
+
 	// Draw entire tree
 	drawElement(mRootElement, target, states);
 }
@@ -100,7 +100,8 @@ public:
 	UIElement* getRoot() const;
 
 	/// <summary>
-	/// Get default text font
+	/// Get default text font.
+	/// Returns NULL in headless mode
 	/// </summary>
 	/// <returns>SFML font</returns>
 	sf::Font* getDefaultFont();
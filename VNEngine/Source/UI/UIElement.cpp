@@ -575,7 +575,7 @@ sf::Vector2f UIElement::coordToLocal(const sf::Vector2f& coord)
 
 sf::Vector2f UIElement::screenToLocal(const sf::Vector2i& screen)
 {
-	return coordToLocal(mEngine->getWindow().mapPixelToCoords(screen));
+	return coordToLocal(mEngine->mapPixelToCoords(screen));
 }
 
 // ============================================================================